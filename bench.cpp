@@ -0,0 +1,258 @@
+// Name         : bench.cpp
+// Author       : Bertin Iradukunda
+// Version      : 1.0
+// Date Created : October 16, 2026
+// Date Modified: October 16, 2026
+// Description  : Micro-benchmarks for the LCMS search engines (build with "make bench")
+//============================================================================
+
+#include "fuzzy.h"
+#include "bktree.h"
+#include "csvreader.h"
+#include "myvector.h"
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <chrono>
+#include <cctype>
+#include <random>
+#include <cstring>
+#define BENCH_SCAN_WINDOW (1 << 20) // Bytes scanned at once by benchCSVScan, as CSVScanner does (extended to the end of the line)
+using namespace std;
+
+// This helper method returns the elapsed time in milliseconds since the given start time
+static double elapsedMs(chrono::steady_clock::time_point start) {
+    return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+}
+
+// This helper method reads the (lowercase) titles of a catalog CSV file
+static void readTitles(const string& path, MyVector<string>& titles) {
+    ifstream infile(path);
+    string line;
+    getline(infile, line); // Skip the header line
+    while (getline(infile, line)) {
+        string title;
+        bool inquotes = false;
+        for (char ch : line) {
+            if (ch == '"') inquotes = !inquotes;
+            else if (ch == ',' && !inquotes) break;
+            else title += tolower(ch);
+        }
+        if (!title.empty()) titles.push_back(title);
+    }
+}
+
+// Benchmark comparing the bit-parallel and the DP edit distance engines over all pairs of titles
+static void benchEditDistance(const string& path, int rounds) {
+    MyVector<string> titles;
+    readTitles(path, titles);
+    if (titles.size() == 0) {
+        cerr << "No titles found in " << path << endl;
+        return;
+    }
+    long pairs = (long)titles.size() * titles.size() * rounds;
+    cout << "Edit distance over " << titles.size() << " titles of " << path << " (" << pairs << " pairs)" << endl;
+
+    long checksumMyers = 0, checksumDP = 0, checksumBounded = 0, checksumBanded = 0;
+
+    auto start = chrono::steady_clock::now();
+    for (int r = 0; r < rounds; r++)
+        for (int i = 0; i < titles.size(); i++)
+            for (int j = 0; j < titles.size(); j++)
+                checksumMyers += levenshtein_distance_myers(titles[i], titles[j]);
+    double myersMs = elapsedMs(start);
+
+    start = chrono::steady_clock::now();
+    for (int r = 0; r < rounds; r++)
+        for (int i = 0; i < titles.size(); i++)
+            for (int j = 0; j < titles.size(); j++) {
+                int full = max(titles[i].length(), titles[j].length());
+                checksumDP += levenshtein_distance_banded(titles[i], titles[j], full);
+            }
+    double dpMs = elapsedMs(start);
+
+    start = chrono::steady_clock::now();
+    for (int r = 0; r < rounds; r++)
+        for (int i = 0; i < titles.size(); i++)
+            for (int j = 0; j < titles.size(); j++)
+                checksumBounded += levenshtein_distance_bounded(titles[i], titles[j], 2);
+    double boundedMs = elapsedMs(start);
+
+    start = chrono::steady_clock::now();
+    for (int r = 0; r < rounds; r++)
+        for (int i = 0; i < titles.size(); i++)
+            for (int j = 0; j < titles.size(); j++)
+                checksumBanded += levenshtein_distance_banded(titles[i], titles[j], 2);
+    double bandedMs = elapsedMs(start);
+
+    cout << "  bit-parallel (full distance) : " << myersMs << " ms" << endl;
+    cout << "  DP (full distance)           : " << dpMs << " ms" << endl;
+    cout << "  dispatch (bounded, k=2)      : " << boundedMs << " ms" << endl;
+    cout << "  banded DP (bounded, k=2)     : " << bandedMs << " ms" << endl;
+    if (checksumMyers != checksumDP || checksumBounded != checksumBanded) {
+        cout << "  MISMATCH between the engines!" << endl;
+    }
+}
+
+// This helper method generates a synthetic catalog of count titles made of 2 to 5 pseudo-words
+static void syntheticTitles(int count, MyVector<string>& titles, mt19937& rng) {
+    static const char* syllables[] = {"an", "ber", "cor", "da", "el", "fi", "gor", "ha", "is", "jun",
+                                      "ka", "lo", "mar", "ne", "or", "pa", "qui", "ro", "sa", "tin"};
+    for (int i = 0; i < count; i++) {
+        string title;
+        int words = 2 + rng() % 4;
+        for (int w = 0; w < words; w++) {
+            if (w > 0) title += ' ';
+            int length = 1 + rng() % 3;
+            for (int k = 0; k < length; k++) title += syllables[rng() % 20];
+        }
+        titles.push_back(title);
+    }
+}
+
+// This helper method applies a random number (1 or 2) of random single-character edits to a string
+static string misspell(string str, mt19937& rng) {
+    int edits = 1 + rng() % 2;
+    for (int e = 0; e < edits && !str.empty(); e++) {
+        int pos = rng() % str.length();
+        switch (rng() % 3) {
+            case 0: str.erase(pos, 1); break;                       // Deletion
+            case 1: str.insert(pos, 1, (char)('a' + rng() % 26)); break; // Insertion
+            default: str[pos] = (char)('a' + rng() % 26); break;    // Substitution
+        }
+    }
+    return str;
+}
+
+// Benchmark showing how many keys a BK-tree lookup visits as the catalog grows
+static void benchBKTree(int queries) {
+    cout << "BK-tree fuzzy lookup (k=2), " << queries << " misspelled queries per catalog size" << endl;
+    int sizes[] = {1000, 10000, 100000, 500000};
+    for (int size : sizes) {
+        mt19937 rng(42);
+        MyVector<string> titles;
+        syntheticTitles(size, titles, rng);
+        BKTree tree;
+        for (int i = 0; i < titles.size(); i++) {
+            tree.insert(titles[i], nullptr);
+        }
+
+        long visited = 0, found = 0;
+        auto start = chrono::steady_clock::now();
+        for (int q = 0; q < queries; q++) {
+            MyVector<BKMatch> matches;
+            visited += tree.search(misspell(titles[rng() % size], rng), 2, matches);
+            found += matches.size();
+        }
+        double ms = elapsedMs(start);
+
+        double perQuery = (double)visited / queries;
+        cout << "  " << size << " titles (" << tree.keys() << " keys): " << perQuery << " keys visited per query ("
+             << 100.0 * perQuery / tree.keys() << "% of the catalog), " << (double)found / queries << " matches, "
+             << ms / queries << " ms per query" << endl;
+    }
+}
+
+// This helper method generates a synthetic catalog CSV of about the given size (quoted titles and authors)
+static void syntheticCSV(size_t bytes, string& csv, mt19937& rng) {
+    MyVector<string> titles;
+    syntheticTitles(1000, titles, rng);
+    csv = "Title,Author,ISBN,Year,Category\n";
+    for (long i = 0; csv.length() < bytes; i++) {
+        csv += "\"" + titles[i % 1000] + ", Volume " + to_string(i) + "\",\"Author " + to_string(i % 5000) + "\",";
+        csv += to_string(9780000000000L + i) + "," + to_string(1900 + i % 120) + ",Category " + to_string(i % 50) + "/Sub " + to_string(i % 7) + "\n";
+    }
+}
+
+// This helper method finds the structural characters of data window by window, reusing the indices buffer
+// (grown if a window is longer than its capacity), and returns their total number
+static size_t scanWindows(const string& data, uint32_t*& indices, size_t& capacity, ScanEngine engine) {
+    size_t found = 0;
+    const char* pos = data.data();
+    const char* end = pos + data.length();
+    while (pos < end) {
+        const char* windowEnd = (end - pos > BENCH_SCAN_WINDOW) ? pos + BENCH_SCAN_WINDOW : end;
+        if (windowEnd < end && windowEnd[-1] != '\n') {
+            const char* lineEnd = (const char*)memchr(windowEnd, '\n', end - windowEnd);
+            windowEnd = (lineEnd == nullptr) ? end : lineEnd + 1;
+        }
+        size_t length = windowEnd - pos;
+        if (length > capacity) {
+            delete[] indices;
+            capacity = length;
+            indices = new uint32_t[capacity];
+        }
+        found += findStructural(pos, length, indices, engine);
+        pos = windowEnd;
+    }
+    return found;
+}
+
+// Benchmark comparing the structural scanners, and the line parsers built on them, on a large synthetic catalog
+static void benchCSVScan(size_t bytes, int rounds) {
+    mt19937 rng(42);
+    string csv;
+    syntheticCSV(bytes, csv, rng);
+    double megabytes = (double)csv.length() * rounds / (1 << 20);
+    cout << "CSV scanning of a " << csv.length() / (1 << 20) << " MB synthetic catalog (" << rounds << " rounds, best engine: "
+         << scanEngineName(bestScanEngine()) << ")" << endl;
+
+    size_t capacity = BENCH_SCAN_WINDOW;
+    uint32_t* indices = new uint32_t[capacity]; // One window of offsets, not one per byte of the catalog
+    ScanEngine engines[] = {SCAN_SCALAR, SCAN_SSE2, SCAN_AVX2};
+    size_t expected = 0;
+    for (ScanEngine engine : engines) {
+        size_t found = 0;
+        auto start = chrono::steady_clock::now();
+        for (int r = 0; r < rounds; r++) {
+            found = scanWindows(csv, indices, capacity, engine);
+        }
+        double ms = elapsedMs(start);
+        cout << "  structural indices, " << scanEngineName(engine) << string(14 - strlen(scanEngineName(engine)), ' ')
+             << ": " << megabytes / (ms / 1000) << " MB/s" << endl;
+        if (expected != 0 && found != expected) {
+            cout << "  MISMATCH between the engines!" << endl;
+        }
+        expected = found;
+    }
+    delete[] indices;
+
+    // Line parsing: the byte at a time splitter against the scanner consuming the structural indices
+    CSVField fields[5];
+    long lines = 0;
+    auto start = chrono::steady_clock::now();
+    for (int r = 0; r < rounds; r++) {
+        const char* line = csv.data();
+        const char* end = line + csv.length();
+        while (line < end) {
+            const char* lineEnd = (const char*)memchr(line, '\n', end - line);
+            if (lineEnd == nullptr) lineEnd = end;
+            lines += splitCSVLine(line, lineEnd, fields, 5) >= 5;
+            line = lineEnd + 1;
+        }
+    }
+    cout << "  line parsing, byte at a time      : " << megabytes / (elapsedMs(start) / 1000) << " MB/s (" << lines / rounds << " lines)" << endl;
+    for (ScanEngine engine : engines) {
+        long parsed = 0;
+        int fieldCount;
+        start = chrono::steady_clock::now();
+        for (int r = 0; r < rounds; r++) {
+            CSVScanner scanner(csv.data(), csv.data() + csv.length(), engine);
+            while (scanner.nextLine(fields, 5, fieldCount)) parsed += fieldCount >= 5;
+        }
+        cout << "  line parsing, " << scanEngineName(engine) << " indices" << string(12 - strlen(scanEngineName(engine)), ' ')
+             << ": " << megabytes / (elapsedMs(start) / 1000) << " MB/s" << endl;
+        if (parsed != lines) {
+            cout << "  MISMATCH between the parsers!" << endl;
+        }
+    }
+}
+
+// main function
+int main(int argc, char* argv[]) {
+    string path = (argc > 1) ? argv[1] : "booklist.csv";
+    benchEditDistance(path, 2000);
+    benchBKTree(200);
+    benchCSVScan(256 << 20, 4);
+    return EXIT_SUCCESS;
+}
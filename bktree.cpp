@@ -0,0 +1,244 @@
+// Name         : bktree.cpp
+// Author       : Bertin Iradukunda
+// Version      : 1.0
+// Date Created : October 16, 2026
+// Date Modified: October 16, 2026
+// Description  : BK-tree (metric tree) used for sub-linear fuzzy lookup of titles and authors
+//============================================================================
+
+#include "bktree.h"
+#include "fuzzy.h"
+#include <cstdlib>
+#include <utility>
+using namespace std;
+
+// Constructor to initialize an empty BK-tree
+BKTree::BKTree() : root(nullptr), keyCount(0), bookCount(0), deadKeys(0) {}
+
+// Destructor to free all the nodes of the BK-tree
+BKTree::~BKTree()
+{
+    clear();
+}
+
+// This method removes every node of the tree
+// It uses an explicit stack, so a degenerate (deep) tree cannot overflow the call stack
+void BKTree::clear()
+{
+    MyVector<BKNode*> stack;
+    if (root != nullptr)
+    {
+        stack.push_back(root);
+    }
+    while (!stack.empty())
+    {
+        BKNode* node = stack.back();
+        stack.erase(stack.size() - 1);
+        for (int i = 0; i < node->children.size(); i++)
+        {
+            stack.push_back(node->children[i]);
+        }
+        delete node;
+    }
+    root = nullptr;
+    keyCount = 0;
+    bookCount = 0;
+    deadKeys = 0;
+}
+
+// This method adds a book under the given key
+// If the key is already in the tree the book is added to its node, otherwise a new node is created
+void BKTree::insert(const string& key, Book* book)
+{
+    bookCount++;
+    if (root == nullptr)
+    {
+        root = new BKNode(key);
+        root->books.push_back(book);
+        keyCount++;
+        return;
+    }
+
+    BKNode* node = root;
+    while (true)
+    {
+        int distance = levenshtein_distance(key, node->key);
+        if (distance == 0)
+        {
+            if (node->books.empty())
+            {
+                deadKeys--; // The key of a removed book is back
+            }
+            node->books.push_back(book); // Same key, share the node
+            return;
+        }
+
+        // Descend into the child stored at the same distance, if there is one
+        BKNode* next = nullptr;
+        for (int i = 0; i < node->children.size(); i++)
+        {
+            if (node->distances[i] == distance)
+            {
+                next = node->children[i];
+                break;
+            }
+        }
+        if (next == nullptr)
+        {
+            node->distances.push_back(distance);
+            node->children.push_back(new BKNode(key));
+            node->children[node->children.size() - 1]->books.push_back(book);
+            keyCount++;
+            return;
+        }
+        node = next;
+    }
+}
+
+// This method finds the node holding exactly the given key
+// It returns the node or nullptr if the key is not in the tree
+BKTree::BKNode* BKTree::findNode(const string& key)
+{
+    BKNode* node = root;
+    while (node != nullptr)
+    {
+        int distance = levenshtein_distance(key, node->key);
+        if (distance == 0)
+        {
+            return node;
+        }
+        BKNode* next = nullptr;
+        for (int i = 0; i < node->children.size(); i++)
+        {
+            if (node->distances[i] == distance)
+            {
+                next = node->children[i];
+                break;
+            }
+        }
+        node = next;
+    }
+    return nullptr;
+}
+
+// This method removes a book stored under the given key
+// The node itself stays in the tree (it still routes the lookups of its children), only its book list shrinks.
+// The empty nodes are still visited by the lookups, so the tree is rebuilt without them once they outnumber the others
+bool BKTree::remove(const string& key, Book* book)
+{
+    BKNode* node = findNode(key);
+    if (node == nullptr)
+    {
+        return false;
+    }
+    for (int i = 0; i < node->books.size(); i++)
+    {
+        if (node->books[i] == book)
+        {
+            node->books.erase(i);
+            bookCount--;
+            if (node->books.empty())
+            {
+                deadKeys++;
+                if (deadKeys > keyCount - deadKeys)
+                {
+                    rebuild();
+                }
+            }
+            return true;
+        }
+    }
+    return false;
+}
+
+// This method rebuilds the tree from the nodes that still hold books, the empty ones are deleted
+// The nodes are reinserted in breadth-first order, so the keys near the root stay near the root
+void BKTree::rebuild()
+{
+    MyVector<BKNode*> order; // Every node of the tree, breadth-first
+    if (root != nullptr)
+    {
+        order.push_back(root);
+    }
+    for (int i = 0; i < order.size(); i++)
+    {
+        for (int c = 0; c < order[i]->children.size(); c++)
+        {
+            order.push_back(order[i]->children[c]);
+        }
+    }
+    root = nullptr;
+    keyCount = 0;
+    bookCount = 0;
+    deadKeys = 0;
+    for (int i = 0; i < order.size(); i++)
+    {
+        for (int b = 0; b < order[i]->books.size(); b++)
+        {
+            insert(order[i]->key, order[i]->books[b]);
+        }
+        delete order[i];
+    }
+}
+
+// This method finds all books whose key is within maxDistance of the query
+// Only the children at a distance in [d - maxDistance, d + maxDistance] of a visited node can hold a match,
+// all other subtrees are pruned without computing any distance
+// It returns the number of nodes visited (distance computations)
+int BKTree::search(const string& query, int maxDistance, MyVector<BKMatch>& matches)
+{
+    int visited = 0;
+    MyVector<BKNode*> stack;
+    if (root != nullptr)
+    {
+        stack.push_back(root);
+    }
+    while (!stack.empty())
+    {
+        BKNode* node = stack.back();
+        stack.erase(stack.size() - 1);
+        visited++;
+
+        int distance = levenshtein_distance(query, node->key);
+        if (distance <= maxDistance)
+        {
+            for (int i = 0; i < node->books.size(); i++)
+            {
+                BKMatch match = {node->books[i], distance};
+                matches.push_back(match);
+            }
+        }
+
+        for (int i = 0; i < node->children.size(); i++)
+        {
+            if (abs(node->distances[i] - distance) <= maxDistance)
+            {
+                stack.push_back(node->children[i]);
+            }
+        }
+    }
+    return visited;
+}
+
+// This method exchanges the nodes and the counters of two trees
+void BKTree::swap(BKTree& other)
+{
+    std::swap(root, other.root);
+    std::swap(keyCount, other.keyCount);
+    std::swap(bookCount, other.bookCount);
+    std::swap(deadKeys, other.deadKeys);
+}
+
+// This method returns the number of distinct keys (nodes) in the tree
+int BKTree::keys() const
+{
+    return keyCount;
+}
+
+// This method returns the number of books stored in the tree
+int BKTree::size() const
+{
+    return bookCount;
+}
+//=============================================================================
+// End of file
@@ -0,0 +1,79 @@
+#ifndef _BKTREE_H
+#define _BKTREE_H
+
+#include <string>
+#include "myvector.h"
+
+using namespace std;
+
+class Book;
+
+// A book matched by a fuzzy lookup, with the edit distance between the query and its key
+struct BKMatch
+{
+	    Book* book;      // The matched book
+	    int distance;    // Levenshtein distance between the query and the key of the book
+};
+
+// Class representing a BK-tree (Burkhard-Keller metric tree) over normalized keys
+// Every node holds one distinct key and the books sharing it; a child is stored under its
+// edit distance to the parent, so a lookup within distance k only has to descend into the children
+// whose distance lies in [d - k, d + k] (triangle inequality)
+class BKTree
+{
+	private:
+	    // Node of the BK-tree
+	    struct BKNode
+	    {
+	        string key;                       // Normalized key stored in this node
+	        MyVector<Book*> books;            // Books having this key (empty once they have all been removed)
+	        MyVector<int> distances;          // Edit distance from key to each child
+	        MyVector<BKNode*> children;       // Child nodes, children[i] is at distance distances[i]
+	        BKNode(const string& key) : key(key) {}
+	    };
+
+	    BKNode* root;    // Root of the BK-tree (nullptr while it is empty)
+	    int keyCount;    // Number of distinct keys (nodes) in the tree
+	    int bookCount;   // Number of books stored in the tree
+	    int deadKeys;    // Nodes left without books by remove, they are dropped by rebuild
+
+	    // Helper method to find the node holding exactly the given key, or nullptr
+	    BKNode* findNode(const string& key);
+
+	    // Helper method to rebuild the tree from the nodes that still hold books
+	    void rebuild();
+
+	public:
+	    // Constructor to initialize an empty BK-tree
+	    BKTree();
+
+	    // Destructor to free all the nodes of the BK-tree (the books are not deleted)
+	    ~BKTree();
+
+	    // Method to add a book under the given key
+	    void insert(const string& key, Book* book);
+
+	    // Method to remove a book stored under the given key, it returns false if it is not found
+	    // Nodes left without books are dropped by a rebuild once they outnumber the nodes still holding books
+	    bool remove(const string& key, Book* book);
+
+	    // Method to find all books whose key is within maxDistance of the query
+	    // It returns the number of nodes (candidate keys) whose distance had to be computed
+	    int search(const string& query, int maxDistance, MyVector<BKMatch>& matches);
+
+	    // Method to remove every node and book from the tree
+	    void clear();
+
+	    // Method to exchange the contents of two trees (O(1), e.g. to free a whole tree on another thread)
+	    void swap(BKTree& other);
+
+	    // Methods to get the number of distinct keys and the number of books in the tree
+	    int keys() const;
+	    int size() const;
+
+	    // The tree owns its nodes, it cannot be copied
+	    BKTree(const BKTree&) = delete;
+	    BKTree& operator=(const BKTree&) = delete;
+};
+
+#endif
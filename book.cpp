@@ -2,28 +2,87 @@
 // Author       : Bertin Iradukunda
 // Version      : 1.0
 // Date Created : April 9, 2025
-// Date Modified: April 9, 2025
+// Date Modified: October 16, 2026
 // Description  : Book class describing a Book in the library system
 //============================================================================
 
 #include "book.h"
+#include "fuzzy.h"
 #include <iostream>
 using namespace std;
 
+ObjectPool<Book> Book::pool;
+StringPool Book::authorPool;
+
+// This operator takes the memory of a new Book from the pool
+// A slot of the pool holds exactly one Book, an object of another size (a derived class) is allocated on the heap
+void* Book::operator new(size_t size)
+{
+    if (size != sizeof(Book))
+    {
+        return ::operator new(size);
+    }
+    return pool.allocate();
+}
+
+// This operator gives the memory of a deleted Book back to where operator new took it from
+void Book::operator delete(void* pointer, size_t size)
+{
+    if (size != sizeof(Book))
+    {
+        ::operator delete(pointer);
+        return;
+    }
+    pool.deallocate(pointer);
+}
+
 // This constructor initializes the book's title, author, ISBN, and publication year
 Book::Book(string title,string author,string isbn, int publication_year) 
 {
     this->title = title;
-    this->author = author;
+    this->author = authorPool.intern(author); // Shared with the other books of the same author
     this->isbn = isbn;
+    this->isbnKey = normalizeIsbn(isbn);
     this->publication_year = publication_year;
+    this->titleKey = normalize_key(title);   // Normalized keys are computed once, when the book is created
+    this->authorKey = authorPool.intern(normalize_key(author));
+    this->category = nullptr;
+    this->sequence = 0;
+}
+
+// This constructor initializes a book from fields that are already normalized and interned, nothing is recomputed
+// but the ISBN number
+Book::Book(string title, const string* author, string isbn, int publication_year, string titleKey, const string* authorKey)
+{
+    this->title.swap(title);
+    this->author = author;
+    this->isbn.swap(isbn);
+    this->isbnKey = normalizeIsbn(this->isbn);
+    this->publication_year = publication_year;
+    this->titleKey.swap(titleKey);
+    this->authorKey = authorKey;
+    this->category = nullptr;
+    this->sequence = 0;
+}
+
+// Destructor, it releases the interned strings of the book
+Book::~Book()
+{
+    authorPool.release(author);
+    authorPool.release(authorKey);
+}
+
+// This method returns the pool of the interned authors
+StringPool& Book::getAuthorPool()
+{
+    return authorPool;
 }
 
 // This method prints the details of the book, including title, author, ISBN, and publication year
 void Book::print()
 {
     cout << "Title: " << title << endl;
-    cout << "Author: " << author << endl;
+    cout << "Author: " << *author << endl;
     cout << "ISBN: " << isbn << endl;
     cout << "Publication Year: " << publication_year << endl;
     cout << "----------------------------------------" << endl;
@@ -32,4 +91,79 @@ void Book::print()
 string Book::getTitle() const
 {
     return title; // Return the title of the book
+}
+
+// This method changes the title of the book and updates its normalized key
+void Book::setTitle(const string& title)
+{
+    this->title = title;
+    this->titleKey = normalize_key(title);
+}
+
+// This method changes the author of the book and updates its normalized key
+void Book::setAuthor(const string& author)
+{
+    const string* oldAuthor = this->author;
+    const string* oldAuthorKey = this->authorKey;
+    this->author = authorPool.intern(author); // Interned before the old ones are released, they may be the same strings
+    this->authorKey = authorPool.intern(normalize_key(author));
+    authorPool.release(oldAuthor);
+    authorPool.release(oldAuthorKey);
+}
+
+// This method changes the ISBN of the book and updates its normalized key
+void Book::setIsbn(const string& isbn)
+{
+    this->isbn = isbn;
+    this->isbnKey = normalizeIsbn(isbn);
+}
+
+// This method normalizes an ISBN into a 64-bit key: the 13 digits of its ISBN-13 form, read as a number
+// Hyphens and spaces are ignored. An ISBN-10 is converted to its ISBN-13 form (978 prefix and a recomputed
+// check digit), so that both forms of the same ISBN have the same key. The check digits are not validated:
+// the catalog keeps ISBNs as entered, and two books entered with the same digits are still the same book
+uint64_t Book::normalizeIsbn(const string& isbn)
+{
+    char digits[13];
+    int count = 0;
+    for (size_t i = 0; i < isbn.length(); i++)
+    {
+        char c = isbn[i];
+        if (c == '-' || c == ' ')
+        {
+            continue;
+        }
+        bool checkX = (c == 'X' || c == 'x') && count == 9; // Check digit 10 of an ISBN-10
+        if (count == 13 || ((c < '0' || c > '9') && !checkX))
+        {
+            return 0;
+        }
+        digits[count++] = c;
+    }
+
+    uint64_t key = 0;
+    if (count == 10)
+    {
+        key = 978;
+        int sum = 9 + 7 * 3 + 8; // Weighted sum of the 978 prefix (weights 1, 3, 1)
+        for (int i = 0; i < 9; i++)
+        {
+            key = key * 10 + (digits[i] - '0');
+            sum += (digits[i] - '0') * (i % 2 == 0 ? 3 : 1);
+        }
+        return key * 10 + (10 - sum % 10) % 10;
+    }
+    if (count != 13 || digits[0] != '9' || digits[1] != '7' || (digits[2] != '8' && digits[2] != '9'))
+    {
+        return 0; // Not an ISBN-13 (they all start with 978 or 979)
+    }
+    for (int i = 0; i < 13; i++)
+    {
+        if (digits[i] == 'X' || digits[i] == 'x')
+        {
+            return 0;
+        }
+        key = key * 10 + (digits[i] - '0');
+    }
+    return key;
 }
\ No newline at end of file
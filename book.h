@@ -2,24 +2,65 @@
 #define _BOOK_H
 
 #include <string>
+#include <cstdint>
+#include "objectpool.h"
+#include "stringpool.h"
 using std::string;
+
+class Node;
+
 // Class representing a Book in the library system
 class Book 
 {
 	private:
 	   string title;              // Title of the book
-	   string author;             // Author of the book
-	   string isbn;               // ISBN (International Standard Book Number) of the book
+	   const string* author;      // Author of the book, interned in authorPool (books by the same author share it)
+	   string isbn;               // ISBN (International Standard Book Number) of the book, as entered
+	   uint64_t isbnKey;          // ISBN normalized to its ISBN-13 number (0 if it is not an ISBN-10/13), key of the ISBN index
 	    int publication_year;           // Year the book was published
+	   string titleKey;           // Normalized title (lowercase, stripped) used by search and lookup
+	   const string* authorKey;   // Normalized author (lowercase, stripped) used by search, interned in authorPool
+	   Node* category;            // Category holding the book (nullptr while it is not in the Tree)
+	   uint64_t sequence;         // Order in which the Tree received the book, the books of a category are in that order
+	   static ObjectPool<Book> pool; // Slabs every Book is allocated from
+	   static StringPool authorPool; // Interned authors and normalized authors of all the books
 
 	public:
 	    // Constructor to initialize a Book object with the provided details
 	    Book(std::string title,string author,string isbn, int publication_year);
 
+	    // Constructor for a book whose normalized title is already known and whose author and normalized author are
+	    // already interned in the author pool (e.g. read from a snapshot), the book takes over one reference of each
+	    Book(string title, const string* author, string isbn, int publication_year, string titleKey, const string* authorKey);
+
+	    // Destructor to release the interned author strings
+	    ~Book();
+
+	    // Books are not copied (each one holds references to the interned strings)
+	    Book(const Book&) = delete;
+	    Book& operator=(const Book&) = delete;
+
 	    // Method to display the details of the book (e.g., title, author, ISBN, publication year)
 	    void print();
 		string getTitle() const; // Method to get the title of the book
 
+	    // Methods to change the title/author of the book, they keep the normalized keys up to date
+	    void setTitle(const string& title);
+	    void setAuthor(const string& author);
+
+	    // Method to change the ISBN of the book, it keeps the normalized ISBN up to date
+	    void setIsbn(const string& isbn);
+
+	    // Method to normalize an ISBN-10 or ISBN-13 into its ISBN-13 number, it returns 0 if the string is not an ISBN
+	    static uint64_t normalizeIsbn(const string& isbn);
+
+	    // Method to get the pool of the interned authors (e.g. to compare an author by address, or for statistics)
+	    static StringPool& getAuthorPool();
+
+	    // Books are allocated from the pool instead of one by one on the heap
+	    static void* operator new(size_t size);
+	    static void operator delete(void* pointer, size_t size);
+
 	    // Friend classes to allow access to private members
 	    friend class Tree;  // Allows the Tree class to access private members of Book
 	    friend class Node;  // Allows the Node class to access private members of Book
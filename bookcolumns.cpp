@@ -0,0 +1,23 @@
+//============================================================================
+// Name         : bookcolumns.cpp
+// Author       : Bertin Iradukunda
+// Version      : 1.0
+// Date Created : October 16, 2026
+// Date Modified: October 16, 2026
+// Description  : Contiguous layout of the books, for the scans over the catalog
+//============================================================================
+
+#include "bookcolumns.h"
+using namespace std;
+
+// This method removes every book from the layout
+void BookColumns::clear() {
+    books.clear();
+}
+
+// This method appends a book to the layout
+void BookColumns::add(Book* book) {
+    books.push_back(book);
+}
+//=============================================================================
+// End of file
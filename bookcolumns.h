@@ -0,0 +1,27 @@
+#ifndef _BOOKCOLUMNS_H
+#define _BOOKCOLUMNS_H
+
+#include "myvector.h"
+
+using namespace std;
+
+class Book;
+
+// Layout of a sequence of books, as one contiguous array of the books
+// The fields are not copied: a scan reads them from the books, whose strings are owned by the Book or interned
+// (the normalized author), so an edit of a book is seen by the next scan without rebuilding anything
+struct BookColumns
+{
+	    MyVector<Book*> books;          // The books themselves
+
+	    // Method to remove every book
+	    void clear();
+
+	    // Method to append a book
+	    void add(Book* book);
+
+	    // Method to get the number of books
+	    int size() const { return books.size(); }
+};
+
+#endif
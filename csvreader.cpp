@@ -0,0 +1,388 @@
+// Name         : csvreader.cpp
+// Author       : Bertin Iradukunda
+// Version      : 1.0
+// Date Created : October 16, 2026
+// Date Modified: October 16, 2026
+// Description  : Zero-copy reading of CSV files: memory-mapped files and in-place field splitting
+//============================================================================
+
+#include "csvreader.h"
+#include <climits>
+#include <cctype>
+#include <iterator>
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#if defined(__x86_64__) || defined(__i386__)
+#define CSV_SCAN_X86 // SSE2 and AVX2 engines are available
+#include <immintrin.h>
+#endif
+using namespace std;
+
+#define CSV_SCAN_WINDOW (1 << 20) // Bytes scanned at once by CSVScanner (extended to the end of the line)
+
+// This method copies the field into str, without its quotes
+void CSVField::assignTo(string& str) const {
+    if (!quoted) {
+        str.assign(data, length);
+        return;
+    }
+    str.clear();
+    for (size_t i = 0; i < length; i++) {
+        if (data[i] != '"') {
+            str += data[i];
+        }
+    }
+}
+
+// Constructor to initialize a view of no file
+MappedFile::MappedFile() : data(nullptr), length(0), mapped(false) {}
+
+// Destructor to unmap (or free) the file
+MappedFile::~MappedFile() {
+    close();
+}
+
+// This method maps the file at the given path
+// If the file cannot be mapped (e.g. a pipe), it is read into a buffer instead
+bool MappedFile::open(const string& path) {
+    close();
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) == 0 && S_ISREG(info.st_mode)) {
+        length = info.st_size;
+        if (length == 0) {
+            ::close(fd);
+            return true; // Nothing to map
+        }
+        void* mapping = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapping != MAP_FAILED) {
+            madvise(mapping, length, MADV_SEQUENTIAL); // The file is read once, from the beginning to the end
+            ::close(fd);
+            data = (const char*)mapping;
+            mapped = true;
+            return true;
+        }
+    }
+    ::close(fd);
+
+    // Fallback: read the whole file into a buffer
+    ifstream infile(path, ios::binary);
+    if (!infile.is_open()) {
+        return false;
+    }
+    string contents((istreambuf_iterator<char>(infile)), istreambuf_iterator<char>());
+    length = contents.length();
+    char* buffer = new char[length + 1];
+    memcpy(buffer, contents.data(), length);
+    data = buffer;
+    mapped = false;
+    return true;
+}
+
+// This method releases the file
+void MappedFile::close() {
+    if (data != nullptr) {
+        if (mapped) {
+            munmap((void*)data, length);
+        }
+        else {
+            delete[] data;
+        }
+    }
+    data = nullptr;
+    length = 0;
+    mapped = false;
+}
+
+// This method splits a line into comma separated fields, in place
+// A quote toggles the quoted state and is not part of the field, a comma only separates fields outside quotes
+int splitCSVLine(const char* begin, const char* end, CSVField* fields, int maxFields) {
+    int count = 0;
+    const char* start = begin;
+    bool inquotes = false;
+    bool quoted = false;
+    for (const char* ptr = begin; ; ptr++) {
+        if (ptr == end || (*ptr == ',' && !inquotes)) {
+            if (count < maxFields) {
+                CSVField field = {start, (size_t)(ptr - start), quoted};
+                fields[count] = field;
+            }
+            count++;
+            if (ptr == end) {
+                return count;
+            }
+            start = ptr + 1;
+            quoted = false;
+        }
+        else if (*ptr == '"') {
+            inquotes = !inquotes;
+            quoted = true;
+        }
+    }
+}
+
+// This method returns the fastest engine supported by the processor
+ScanEngine bestScanEngine() {
+#ifdef CSV_SCAN_X86
+    static ScanEngine best = __builtin_cpu_supports("avx2") ? SCAN_AVX2 : SCAN_SSE2;
+    return best;
+#else
+    return SCAN_SCALAR;
+#endif
+}
+
+// This method returns the name of an engine
+const char* scanEngineName(ScanEngine engine) {
+    switch (engine) {
+        case SCAN_SSE2: return "SSE2";
+        case SCAN_AVX2: return "AVX2";
+        default: return "scalar";
+    }
+}
+
+// This helper method finds the structural characters one byte at a time
+static size_t findStructural_scalar(const char* data, size_t length, uint32_t* indices) {
+    size_t count = 0;
+    bool inquotes = false;
+    for (size_t i = 0; i < length; i++) {
+        char ch = data[i];
+        if (ch == '"') {
+            inquotes = !inquotes;
+            indices[count++] = i;
+        }
+        else if (ch == '\n') {
+            inquotes = false; // The quoted state ends with the line
+            indices[count++] = i;
+        }
+        else if (ch == ',' && !inquotes) {
+            indices[count++] = i;
+        }
+    }
+    return count;
+}
+
+#ifdef CSV_SCAN_X86
+// This helper method returns, for every bit, the parity of the bits set up to and including it
+// Applied to the quotes of a block, it gives the bytes that are between quotes
+static inline uint64_t prefixXor(uint64_t bits) {
+    bits ^= bits << 1;
+    bits ^= bits << 2;
+    bits ^= bits << 4;
+    bits ^= bits << 8;
+    bits ^= bits << 16;
+    bits ^= bits << 32;
+    return bits;
+}
+
+// This helper method turns the masks of the quotes, commas and line breaks of a 64-byte block into offsets
+// inquotes carries the quoted state from one block to the next
+static inline size_t emitBlock(uint64_t quotes, uint64_t commas, uint64_t newlines, bool& inquotes, uint32_t base, uint32_t* indices) {
+    uint64_t inside = prefixXor(quotes) ^ (inquotes ? ~0ULL : 0ULL);
+    // A line break closes the quotes: the state is flipped from there on if it was open
+    for (uint64_t lines = newlines; lines != 0; lines &= lines - 1) {
+        int pos = __builtin_ctzll(lines);
+        if ((inside >> pos) & 1) {
+            inside ^= ~0ULL << pos;
+        }
+    }
+    inquotes = (inside >> 63) & 1;
+
+    uint64_t structural = quotes | (commas & ~inside) | newlines;
+    size_t count = 0;
+    while (structural != 0) {
+        indices[count++] = base + __builtin_ctzll(structural);
+        structural &= structural - 1;
+    }
+    return count;
+}
+
+// This helper method finds the structural characters 16 bytes at a time (SSE2)
+static size_t findStructural_sse2(const char* data, size_t length, uint32_t* indices) {
+    const __m128i quote = _mm_set1_epi8('"'), comma = _mm_set1_epi8(','), newline = _mm_set1_epi8('\n');
+    char tail[64];
+    size_t count = 0;
+    bool inquotes = false;
+    for (size_t offset = 0; offset < length; offset += 64) {
+        const char* block = data + offset;
+        if (length - offset < 64) {
+            memset(tail, 0, sizeof(tail)); // The last block is padded with bytes that are not structural
+            memcpy(tail, block, length - offset);
+            block = tail;
+        }
+        uint64_t quotes = 0, commas = 0, newlines = 0;
+        for (int i = 0; i < 4; i++) {
+            __m128i bytes = _mm_loadu_si128((const __m128i*)(block + 16 * i));
+            quotes |= (uint64_t)(uint16_t)_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, quote)) << (16 * i);
+            commas |= (uint64_t)(uint16_t)_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, comma)) << (16 * i);
+            newlines |= (uint64_t)(uint16_t)_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, newline)) << (16 * i);
+        }
+        count += emitBlock(quotes, commas, newlines, inquotes, offset, indices + count);
+    }
+    return count;
+}
+
+// This helper method finds the structural characters 32 bytes at a time (AVX2)
+__attribute__((target("avx2")))
+static size_t findStructural_avx2(const char* data, size_t length, uint32_t* indices) {
+    const __m256i quote = _mm256_set1_epi8('"'), comma = _mm256_set1_epi8(','), newline = _mm256_set1_epi8('\n');
+    char tail[64];
+    size_t count = 0;
+    bool inquotes = false;
+    for (size_t offset = 0; offset < length; offset += 64) {
+        const char* block = data + offset;
+        if (length - offset < 64) {
+            memset(tail, 0, sizeof(tail)); // The last block is padded with bytes that are not structural
+            memcpy(tail, block, length - offset);
+            block = tail;
+        }
+        uint64_t quotes = 0, commas = 0, newlines = 0;
+        for (int i = 0; i < 2; i++) {
+            __m256i bytes = _mm256_loadu_si256((const __m256i*)(block + 32 * i));
+            quotes |= (uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(bytes, quote)) << (32 * i);
+            commas |= (uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(bytes, comma)) << (32 * i);
+            newlines |= (uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(bytes, newline)) << (32 * i);
+        }
+        count += emitBlock(quotes, commas, newlines, inquotes, offset, indices + count);
+    }
+    return count;
+}
+#endif
+
+// This method finds the structural characters of a buffer with the given engine
+// An engine that the build or the processor does not support falls back to the next best one
+size_t findStructural(const char* data, size_t length, uint32_t* indices, ScanEngine engine) {
+#ifdef CSV_SCAN_X86
+    if (engine == SCAN_AVX2 && bestScanEngine() == SCAN_AVX2) {
+        return findStructural_avx2(data, length, indices);
+    }
+    if (engine != SCAN_SCALAR) {
+        return findStructural_sse2(data, length, indices);
+    }
+#endif
+    return findStructural_scalar(data, length, indices);
+}
+
+// Constructor to read the lines of [begin, end)
+CSVScanner::CSVScanner(const char* begin, const char* end, ScanEngine engine)
+    : pos(begin), end(end), window(begin), windowEnd(begin), lineStart(begin),
+      indices(nullptr), indexCapacity(0), indexCount(0), next(0), engine(engine) {}
+
+// Destructor to free the offsets buffer
+CSVScanner::~CSVScanner() {
+    delete[] indices;
+}
+
+// This method scans the next window: about CSV_SCAN_WINDOW bytes, extended to the end of the line
+void CSVScanner::loadWindow() {
+    window = pos;
+    windowEnd = (end - pos > CSV_SCAN_WINDOW) ? pos + CSV_SCAN_WINDOW : end;
+    if (windowEnd < end && windowEnd[-1] != '\n') {
+        const char* lineEnd = (const char*)memchr(windowEnd, '\n', end - windowEnd);
+        windowEnd = (lineEnd == nullptr) ? end : lineEnd + 1;
+    }
+    size_t length = windowEnd - window;
+    if (length > indexCapacity) {
+        delete[] indices;
+        indexCapacity = max(length, (size_t)CSV_SCAN_WINDOW);
+        indices = new uint32_t[indexCapacity];
+    }
+    indexCount = findStructural(window, length, indices, engine);
+    next = 0;
+    lineStart = window;
+    pos = windowEnd;
+}
+
+// This method gets the next non-empty line, by consuming the structural characters up to its line break
+// A quote marks its field as quoted, a comma ends a field, a line break ends the field and the line
+bool CSVScanner::nextLine(CSVField* fields, int maxFields, int& fieldCount) {
+    while (true) {
+        if (lineStart >= windowEnd) {
+            if (pos >= end) {
+                return false; // No more data
+            }
+            loadWindow();
+            continue;
+        }
+        const char* start = lineStart;
+        const char* fieldStart = start;
+        const char* lineEnd = windowEnd; // The last line of the data may have no line break
+        bool quoted = false;
+        fieldCount = 0;
+        while (next < indexCount) {
+            const char* ch = window + indices[next++];
+            if (*ch == '"') {
+                quoted = true;
+                continue;
+            }
+            if (fieldCount < maxFields) {
+                CSVField field = {fieldStart, (size_t)(ch - fieldStart), quoted};
+                fields[fieldCount] = field;
+            }
+            fieldCount++;
+            fieldStart = ch + 1;
+            quoted = false;
+            if (*ch == '\n') {
+                lineEnd = ch;
+                break;
+            }
+        }
+        if (lineEnd == windowEnd) {
+            if (fieldCount < maxFields) {
+                CSVField field = {fieldStart, (size_t)(windowEnd - fieldStart), quoted};
+                fields[fieldCount] = field;
+            }
+            fieldCount++;
+            lineStart = windowEnd;
+        }
+        else {
+            lineStart = lineEnd + 1;
+        }
+        if (lineEnd != start) {
+            return true;
+        }
+        // Skip empty lines
+    }
+}
+
+// This method parses an integer like stoi, without exceptions
+bool parseInt(const char* data, size_t length, int& value) {
+    size_t pos = 0;
+    while (pos < length && isspace((unsigned char)data[pos])) {
+        pos++; // Skip leading whitespace
+    }
+    bool negative = false;
+    if (pos < length && (data[pos] == '-' || data[pos] == '+')) {
+        negative = (data[pos] == '-');
+        pos++;
+    }
+    size_t first = pos;
+    long long result = 0;
+    while (pos < length && data[pos] >= '0' && data[pos] <= '9') {
+        result = result * 10 + (data[pos] - '0');
+        if (result > (long long)INT_MAX + 1) {
+            return false; // Out of range
+        }
+        pos++;
+    }
+    if (pos == first) {
+        return false; // No digit
+    }
+    if (negative) {
+        result = -result;
+    }
+    if (result > INT_MAX || result < INT_MIN) {
+        return false;
+    }
+    value = (int)result;
+    return true;
+}
+//=============================================================================
+// End of file
@@ -0,0 +1,116 @@
+#ifndef _CSVREADER_H
+#define _CSVREADER_H
+
+#include <string>
+#include <cstddef>
+#include <cstdint>
+
+using namespace std;
+
+// A field of a CSV line, referring to the bytes of the line in place (nothing is copied)
+// The quotes of a field are only removed when it is copied into a string
+struct CSVField
+{
+	    const char* data;   // First byte of the field (quotes included)
+	    size_t length;      // Number of bytes of the field
+	    bool quoted;        // True if the field contains quotes that must be removed
+
+	    // Method to copy the field (without its quotes) into str, reusing the capacity of str
+	    void assignTo(string& str) const;
+};
+
+// Class representing a read-only view of a whole file
+// The file is memory-mapped when possible, otherwise it is read into a buffer
+class MappedFile
+{
+	private:
+	    const char* data;   // First byte of the file (nullptr for an empty file)
+	    size_t length;      // Size of the file in bytes
+	    bool mapped;        // True if data is a memory mapping, false if it is a buffer allocated with new[]
+
+	    // The mapping cannot be shared between two objects
+	    MappedFile(const MappedFile&);
+	    MappedFile& operator=(const MappedFile&);
+
+	public:
+	    // Constructor to initialize a view of no file
+	    MappedFile();
+
+	    // Destructor to unmap (or free) the file
+	    ~MappedFile();
+
+	    // Method to map the file at the given path, returns false if it cannot be opened
+	    bool open(const string& path);
+
+	    // Method to release the file
+	    void close();
+
+	    // Methods to get the bytes of the file
+	    const char* begin() const { return data; }
+	    const char* end() const { return data + length; }
+	    size_t size() const { return length; }
+};
+
+// This method splits the line [begin, end) into comma separated fields, commas between quotes excluded
+// The first maxFields fields are stored in fields, the returned value is the total number of fields
+int splitCSVLine(const char* begin, const char* end, CSVField* fields, int maxFields);
+
+// Engines available to find the structural characters of a CSV file
+enum ScanEngine
+{
+	    SCAN_SCALAR,    // One byte at a time
+	    SCAN_SSE2,      // 16 bytes at a time (x86)
+	    SCAN_AVX2       // 32 bytes at a time (x86 processors supporting AVX2)
+};
+
+// This method returns the fastest engine supported by the processor
+ScanEngine bestScanEngine();
+
+// This method returns the name of an engine (e.g. "AVX2")
+const char* scanEngineName(ScanEngine engine);
+
+// This method finds the structural characters of [data, data + length): the quotes, the commas outside quotes
+// and the line breaks (the quoted state ends with the line). Their offsets are written, in increasing order,
+// to indices (which must have room for length offsets) and their number is returned
+size_t findStructural(const char* data, size_t length, uint32_t* indices, ScanEngine engine);
+
+// Class representing a line by line reader of CSV data, driven by the structural characters
+// The data is scanned window by window (each window ends with a line), so the offsets fit in 32 bits and
+// their buffer stays small whatever the size of the file
+class CSVScanner
+{
+	private:
+	    const char* pos;          // First byte not scanned yet
+	    const char* end;          // End of the data
+	    const char* window;       // First byte of the current window
+	    const char* windowEnd;    // End of the current window
+	    const char* lineStart;    // First byte of the next line in the window
+	    uint32_t* indices;        // Offsets (from window) of the structural characters of the window
+	    size_t indexCapacity;     // Number of offsets indices can hold
+	    size_t indexCount;        // Number of offsets found in the window
+	    size_t next;              // Next offset to consume
+	    ScanEngine engine;        // Engine used to scan the windows
+
+	    // Helper method to scan the next window
+	    void loadWindow();
+
+	    // The buffer cannot be shared between two objects
+	    CSVScanner(const CSVScanner&);
+	    CSVScanner& operator=(const CSVScanner&);
+
+	public:
+	    // Constructor to read the lines of [begin, end)
+	    CSVScanner(const char* begin, const char* end, ScanEngine engine = bestScanEngine());
+
+	    // Destructor to free the offsets buffer
+	    ~CSVScanner();
+
+	    // Method to get the next non-empty line, split like splitCSVLine (returns false at the end of the data)
+	    bool nextLine(CSVField* fields, int maxFields, int& fieldCount);
+};
+
+// This method parses an integer the way stoi does (leading whitespace, optional sign, digits up to the first other character)
+// It returns false, instead of throwing, if there is no digit or if the value does not fit in an int
+bool parseInt(const char* data, size_t length, int& value);
+
+#endif
@@ -0,0 +1,202 @@
+// Name         : fuzzy.cpp
+// Author       : Bertin Iradukunda
+// Version      : 1.0
+// Date Created : October 16, 2026
+// Date Modified: October 16, 2026
+// Description  : Search key helpers and edit distance engines used by the fuzzy search (bit-parallel and banded DP)
+//============================================================================
+
+#include "fuzzy.h"
+#include "myvector.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstdint>
+#include <cctype>
+using namespace std;
+
+// Engines shared by the std::string and the (pointer, length) versions of the distances
+static int myers_distance(const char* s1, size_t len1, const char* s2, size_t len2);
+static int banded_distance(const char* s1, size_t len1, const char* s2, size_t len2, int maxDistance);
+
+// This helper method converts a string to lowercase
+// It iterates through each character and converts it to lowercase and returns the new string
+string toLowerCase(const string& str) {
+    string lowerStr;
+    for (char c : str) {  // Iterate through each character in the string
+        lowerStr += tolower(c);
+    }
+    return lowerStr;
+}
+
+// Helper function to remove leading and rear edge whitespace
+string strip_whitespace(const string& str) {
+    size_t start = str.find_first_not_of(" \t\n\r"); // Find the first non-whitespace character
+    size_t end = str.find_last_not_of(" \t\n\r"); // Find the last non-whitespace character
+    return (start == string::npos || end == string::npos) ? "" : str.substr(start, end - start + 1); // Return the substring without leading and rear edge whitespace, if any
+}
+
+// This helper method builds the search key of a string (lowercase, without leading and rear edge whitespace)
+// It is equivalent to toLowerCase(strip_whitespace(str)) but builds the key in a single allocation
+string normalize_key(const string& str) {
+    size_t start = str.find_first_not_of(" \t\n\r"); // Find the first non-whitespace character
+    if (start == string::npos) {
+        return ""; // Only whitespace
+    }
+    size_t end = str.find_last_not_of(" \t\n\r"); // Find the last non-whitespace character
+    string key(str, start, end - start + 1);
+    for (size_t i = 0; i < key.length(); i++) {
+        key[i] = tolower((unsigned char)key[i]);
+    }
+    return key;
+}
+
+// This method calculates the Levenshtein distance between two strings
+// It takes two strings as input and returns the minimum number of single-character edits (insertions,
+// deletions, or substitutions) required to change one string into the other
+int levenshtein_distance(const string &s1, const string &s2) {
+    // Use the bit-parallel engine whenever the shorter string fits in a machine word
+    if (min(s1.length(), s2.length()) <= MYERS_MAX_PATTERN) {
+        return levenshtein_distance_myers(s1, s2);
+    }
+    // Otherwise fall back to the DP with a band wide enough to hold every cell
+    int maxDistance = max(s1.length(), s2.length());
+    return levenshtein_distance_banded(s1, s2, maxDistance);
+}
+
+// This method calculates the Levenshtein distance between two strings, but only up to maxDistance
+// It returns the exact distance if it is <= maxDistance, otherwise it returns maxDistance + 1
+int levenshtein_distance_bounded(const string &s1, const string &s2, int maxDistance) {
+    return levenshtein_distance_bounded(s1.data(), s1.length(), s2.data(), s2.length(), maxDistance);
+}
+
+// This method is the same as above, on strings given by their first character and length (e.g. inside a mapped file)
+int levenshtein_distance_bounded(const char* s1, size_t len1, const char* s2, size_t len2, int maxDistance) {
+    // The distance is at least the difference in length
+    if (abs((int)len1 - (int)len2) > maxDistance) {
+        return maxDistance + 1;
+    }
+    if (min(len1, len2) <= MYERS_MAX_PATTERN) {
+        return min(myers_distance(s1, len1, s2, len2), maxDistance + 1);
+    }
+    return banded_distance(s1, len1, s2, len2, maxDistance);
+}
+
+// This method calculates the Levenshtein distance with the bit-parallel algorithm of Myers (1999),
+// in the formulation of Hyyro (2001) for global edit distance
+// The shorter string is the pattern, each of its characters is one bit of a 64-bit word, and one
+// column of the DP table is computed per character of the text in a constant number of word operations
+int levenshtein_distance_myers(const string &s1, const string &s2) {
+    return myers_distance(s1.data(), s1.length(), s2.data(), s2.length());
+}
+
+// This helper method is the bit-parallel engine, on strings given by their first character and length
+static int myers_distance(const char* s1, size_t len1, const char* s2, size_t len2) {
+    const char* pattern = (len1 <= len2) ? s1 : s2; // Shorter string
+    const char* text = (len1 <= len2) ? s2 : s1;    // Longer string
+    int m = min(len1, len2);
+    size_t textLength = max(len1, len2);
+
+    if (m == 0) {
+        return textLength; // Only insertions are needed
+    }
+
+    // Match masks: bit i of peq[c] is set if pattern[i] == c
+    // The table is kept between calls and only the entries used by the pattern are cleared afterwards
+    static thread_local uint64_t peq[256] = {0};
+    for (int i = 0; i < m; ++i) {
+        peq[(unsigned char)pattern[i]] |= (uint64_t)1 << i;
+    }
+
+    uint64_t last = (uint64_t)1 << (m - 1); // Bit of the last row of the table
+    uint64_t pv = ~(uint64_t)0;             // Positive vertical deltas (first column is 0..m)
+    uint64_t mv = 0;                        // Negative vertical deltas
+    int score = m;                          // Value of the last row in the current column
+
+    for (size_t j = 0; j < textLength; ++j) {
+        uint64_t eq = peq[(unsigned char)text[j]];
+        uint64_t xv = eq | mv;
+        uint64_t xh = (((eq & pv) + pv) ^ pv) | eq;
+        uint64_t ph = mv | ~(xh | pv);      // Positive horizontal deltas
+        uint64_t mh = pv & xh;              // Negative horizontal deltas
+
+        if (ph & last) {
+            score++;
+        } else if (mh & last) {
+            score--;
+        }
+
+        // The first row grows by one per column, hence the carried-in bit on ph
+        ph = (ph << 1) | 1;
+        mh = mh << 1;
+        pv = mh | ~(xv | ph);
+        mv = ph & xv;
+    }
+
+    // Reset the match masks used by this pattern
+    for (int i = 0; i < m; ++i) {
+        peq[(unsigned char)pattern[i]] = 0;
+    }
+
+    return score; // Return the Levenshtein distance
+}
+
+// This method calculates the Levenshtein distance between two strings, but only up to maxDistance
+// It returns the exact distance if it is <= maxDistance, otherwise it returns maxDistance + 1
+// Only the diagonal band of width 2*maxDistance+1 is filled, using a single reusable row,
+// and the computation stops as soon as every cell of the current row exceeds maxDistance
+int levenshtein_distance_banded(const string &s1, const string &s2, int maxDistance) {
+    return banded_distance(s1.data(), s1.length(), s2.data(), s2.length(), maxDistance);
+}
+
+// This helper method is the banded DP engine, on strings given by their first character and length
+static int banded_distance(const char* s1, size_t len1, const char* s2, size_t len2, int maxDistance) {
+    int len_s1 = len1;
+    int len_s2 = len2;
+    int limit = maxDistance + 1; // Any value above maxDistance is reported as limit
+
+    // The distance is at least the difference in length
+    if (abs(len_s1 - len_s2) > maxDistance) {
+        return limit;
+    }
+
+    // Scratch row reused across calls, so no allocation is needed once it is large enough
+    static thread_local MyVector<int> row;
+    while (row.size() < len_s2 + 1) {
+        row.push_back(0);
+    }
+
+    // Initialize the first row, cells outside the band are set to the limit
+    for (int j = 0; j <= len_s2; ++j) {
+        row[j] = (j <= maxDistance) ? j : limit;
+    }
+
+    // Compute the distances row by row, only inside the band [i - maxDistance, i + maxDistance]
+    for (int i = 1; i <= len_s1; ++i) {
+        int lo = std::max(1, i - maxDistance);
+        int hi = std::min(len_s2, i + maxDistance);
+
+        int diag = row[lo - 1];                                         // Value of the previous row at column lo - 1
+        row[lo - 1] = (lo == 1) ? std::min(i, limit) : limit;           // Left edge of the band for the current row
+        int rowMin = row[lo - 1];
+
+        for (int j = lo; j <= hi; ++j) {
+            int up = row[j];
+            int cost = (s1[i - 1] == s2[j - 1]) ? 0 : 1;
+            int value = std::min({up + 1,                // Deletion
+                                  row[j - 1] + 1,        // Insertion
+                                  diag + cost});         // Substitution
+            diag = up;
+            row[j] = std::min(value, limit);
+            rowMin = std::min(rowMin, row[j]);
+        }
+
+        // Stop early if the whole band already exceeds the maximum distance
+        if (rowMin > maxDistance) {
+            return limit;
+        }
+    }
+
+    return std::min(row[len_s2], limit); // Return the bounded Levenshtein distance
+}
+//=============================================================================
+// End of file
@@ -0,0 +1,38 @@
+#ifndef _FUZZY_H
+#define _FUZZY_H
+
+#include <string>
+#include <cstddef>
+
+// Largest edit distance accepted by the fuzzy searches
+#define FUZZY_SEARCH_THRESHOLD 2
+
+// Longest pattern handled by the bit-parallel engine (one bit per character in a 64-bit word)
+#define MYERS_MAX_PATTERN 64
+
+// Helper function to convert a string to lowercase
+std::string toLowerCase(const std::string& str);
+
+// Helper function to remove leading and rear edge whitespace
+std::string strip_whitespace(const std::string& str);
+
+// Helper function to build the normalized search key of a string (lowercase and stripped)
+// Every case-insensitive comparison in the catalog is done on these keys
+std::string normalize_key(const std::string& str);
+
+// Function to compute the Levenshtein distance between two strings
+// Uses the bit-parallel engine when the shorter string fits in a machine word, the banded DP otherwise
+int levenshtein_distance(const std::string &s1, const std::string &s2);
+
+// Function to compute the Levenshtein distance between two strings, bounded by maxDistance
+// Returns maxDistance + 1 when the distance is larger than maxDistance
+int levenshtein_distance_bounded(const std::string &s1, const std::string &s2, int maxDistance);
+int levenshtein_distance_bounded(const char* s1, size_t len1, const char* s2, size_t len2, int maxDistance);
+
+// Bit-parallel (Myers/Hyyro) edit distance, the shorter string must not exceed MYERS_MAX_PATTERN characters
+int levenshtein_distance_myers(const std::string &s1, const std::string &s2);
+
+// Banded dynamic programming edit distance, bounded by maxDistance (works for strings of any length)
+int levenshtein_distance_banded(const std::string &s1, const std::string &s2, int maxDistance);
+
+#endif
@@ -8,129 +8,443 @@
 //============================================================================
 
 #include "lcms.h"
+#include "csvreader.h"
 #include <iostream>
 #include <exception>
 #include <fstream>
 #include <sstream>
 #include <string>
+#include <chrono>
+#include <iomanip>
+#include <cstring>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <climits>
+#include <unordered_map>
+#include <unordered_set>
 using namespace std;
 // Define color codes
 #define COLOR_RED     "\033[31m"
 #define COLOR_GREEN   "\033[32m"
 #define COLOR_RESET   "\033[0m"
 
+#define PARALLEL_IMPORT_MIN_BYTES (4 << 20) // Files smaller than this (4 MB) are imported by a single thread
+#define PARALLEL_IMPORT_MAX_THREADS 16      // Most threads an import uses, whatever the number of cores or --threads
+#define IMPORT_CHUNK_BYTES (1 << 20)        // Size of the chunks a parallel import splits the file into (1 MB)
+#define IMPORT_SAMPLE_BYTES (1 << 20)       // Bytes whose lines are counted to estimate the number of books of a file
+
 // Constructor to initialize the LCMS with a root category name 
 LCMS::LCMS(string name) {
     libTree = new Tree(name); // Create a Tree with the given name
+    snapshot = nullptr; // Queries are served by the Tree until a snapshot is opened
 }
 
 // Destructor to clean allocated memory
 LCMS::~LCMS() {
     delete libTree; // Delete the Tree to free up memory
+    delete snapshot; // Unmap the snapshot, if one is open
+}
+
+// This method rejects a command that needs the Tree while the catalog is served read-only from a snapshot
+bool LCMS::readOnly(const string& command) {
+    if (snapshot == nullptr) {
+        return false;
+    }
+    cout << COLOR_RED << "The catalog is open read-only: " << command << " is not available." << COLOR_RESET << endl; // Print an error message
+    return true;
+}
+
+// This method opens a snapshot file (written by save) read-only
+// The queries are then answered from the mapped file, without creating any Book or Node
+void LCMS::open(string path) {
+    if (path.empty()) { // If no file is provided
+        cout << COLOR_RED << "No file provided. Please enter a file name." << COLOR_RESET << endl; // Print an error message
+        return;
+    }
+    if (readOnly("open")) {
+        return;
+    }
+    if (!libTree->isEmpty()) {
+        cout << COLOR_RED << "The catalog is not empty, a snapshot can only be opened in an empty catalog." << COLOR_RESET << endl;
+        return;
+    }
+    auto start = chrono::steady_clock::now();
+    string error;
+    SnapshotView* view = new SnapshotView();
+    if (!view->open(path, error)) {
+        cerr << COLOR_RED << "Could not open " << path << ": " << error << COLOR_RESET << endl; // Print an error message if the snapshot cannot be used
+        delete view;
+        return;
+    }
+    snapshot = view;
+    double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+    cout << COLOR_GREEN << snapshot->bookCount() << " books opened read-only from " << path << COLOR_RESET << endl;
+    ios::fmtflags flags = cout.flags(); // Format of cout, restored once the figures are printed
+    streamsize precision = cout.precision();
+    cout << "Opened in " << fixed << setprecision(2) << ms << " ms" << endl; // Print the opening time
+    cout.flags(flags);
+    cout.precision(precision);
+}
+
+// This helper method estimates the number of lines of [begin, end) from the lines of its first megabyte
+// (exact for a smaller file), so that the file is not read once more only to count its lines
+static unsigned int estimateLines(const char* begin, const char* end) {
+    const char* sampleEnd = begin + min((size_t)(end - begin), (size_t)IMPORT_SAMPLE_BYTES);
+    double lines = 0;
+    for (const char* pos = begin; pos < sampleEnd; lines++) {
+        const char* lineEnd = (const char*)memchr(pos, '\n', sampleEnd - pos);
+        pos = (lineEnd == nullptr) ? sampleEnd : lineEnd + 1;
+    }
+    if (sampleEnd != end) {
+        lines = lines * (end - begin) / (sampleEnd - begin);
+    }
+    return (unsigned int)min(lines, (double)UINT_MAX);
 }
 
 // This method import data from a file located at the given path
 int LCMS::import(string path) {
-    ifstream infile(path); // Open the file in reading mode at the given path
-    if (!infile.is_open()) { // Check if the infile is open
+    if (readOnly("import")) {
+        return -1;
+    }
+    // "import <file> --threads N" sets the number of threads, by default large files are imported on all the cores
+    int threads = 0;
+    size_t option = path.rfind("--threads");
+    if (option != string::npos && (option == 0 || path[option - 1] == ' ')) {
+        string value = strip_whitespace(path.substr(option + 9));
+        if (value.empty() || value.length() > 3 || value.find_first_not_of("0123456789") != string::npos || stoi(value) == 0) {
+            cerr << COLOR_RED << "Invalid value for --threads. Please enter a positive number of threads." << COLOR_RESET << endl;
+            return -1;
+        }
+        threads = stoi(value);
+        if (threads > PARALLEL_IMPORT_MAX_THREADS) {
+            cout << "--threads " << threads << " is more than the maximum, using " << PARALLEL_IMPORT_MAX_THREADS << " threads." << endl;
+            threads = PARALLEL_IMPORT_MAX_THREADS;
+        }
+        path = strip_whitespace(path.substr(0, option));
+    }
+
+    MappedFile infile; // The file is scanned in place, without copying its lines
+    if (!infile.open(path)) { // Check if the infile is open
         cerr << COLOR_RED << "Could not open file " << path << COLOR_RESET << endl; // Print an error message if the file opening fails
         return -1; 
     }
 
-    string line;
     int count = 0; // Initialize a counter for the number of books imported
-    getline(infile, line); // Read the header line from the file for purpose of skipping it
-    while (getline(infile, line)) { // Read each book from the file
-        MyVector<string> book_details;
-        string detail;
-        bool inquotes = false; // Flag to track if we are inside quotes
-        // check if the line is empty
-        if (line.empty()) {
-            continue; // Skip empty strings
-        }
-
-        // Parse the line into book details
-        for (char ch : line) {
-            if (ch == '"') {
-                inquotes = !inquotes; // update inquotes state
-            } 
-            else if (ch == ',' && !inquotes) {
-                book_details.push_back(detail);
-                detail.clear();
-            } 
-            else {
-                detail += ch; // Append character to detail
-            }
-        }
-        book_details.push_back(detail); // Add the last detail
+    const char* end = infile.end();
+    const char* line = (const char*)memchr(infile.begin(), '\n', infile.size()); // Skip the header line
+    line = (line == nullptr) ? end : line + 1;
+
+    if (threads == 0) {
+        threads = (infile.size() >= PARALLEL_IMPORT_MIN_BYTES) ? min((int)thread::hardware_concurrency(), PARALLEL_IMPORT_MAX_THREADS) : 1;
+    }
 
+    CSVField book_details[5]; // Fields of the current line, referring to the bytes of the file
+    string title, author, isbn, year, category; // Reused for every line, so that they keep their capacity
+    libTree->beginBulkLoad(estimateLines(line, end)); // Book counts are computed once at the end, duplicates are checked through a hash set
+    if (threads > 1) {
+        count = importParallel(line, end, threads);
+        line = end; // The whole file has been imported
+    }
+    CSVScanner scanner(line, end); // Finds the commas and line breaks with SIMD instructions, empty lines are skipped
+    int fieldCount;
+    while (scanner.nextLine(book_details, 5, fieldCount)) { // Read each book from the file
         // Check if we have enough book_details
-        if (book_details.size() < 5) {
+        if (fieldCount < 5) {
             cerr << COLOR_RED << "Incomplete book details" << COLOR_RESET << endl;
             continue;
         }
 
-        string title = book_details[0];
-        string author = book_details[1];
-        string isbn = book_details[2];
-        string year = book_details[3];
-        string category = book_details[4];
+        book_details[0].assignTo(title);
+        book_details[1].assignTo(author);
+        book_details[2].assignTo(isbn);
+        book_details[4].assignTo(category);
         Node* categoryNode = libTree->getNode(category); // Get the category node from the tree
         if (categoryNode == nullptr) { // If the category node does not exist
             categoryNode = libTree->createNode(category); // Create a new category node in the tree
         }
-        // Check for duplicate book in the category
-        bool duplicate = false;
-        for (int i = 0; i < categoryNode->books.size(); i++) {
-            Book* book = categoryNode->books[i];
-            if (book->title == title && book->author == author && book->isbn == isbn) {
-                cout << COLOR_RED << "The book \"" << title << "\" by " << author << " already exists in the catalog." << COLOR_RESET << endl;
-                duplicate = true;
-                break; // Skip adding the book if already exists
-            }
+        // Check for duplicate book in the catalog (by ISBN) or in the category
+        if (libTree->containsBook(categoryNode, title, author, isbn)) {
+            cout << COLOR_RED << "The book \"" << title << "\" by " << author << " already exists in the catalog." << COLOR_RESET << endl;
+            continue; // Skip adding the book if already exists
         }
-        if (duplicate) continue;
-        Book* newBook = nullptr; 
-        try {
-            int publicationYear = stoi(year); // Convert year to integer
-            newBook = new Book(title, author, isbn, publicationYear); // Create a new Book object with the parsed data
-        } 
-        catch (const invalid_argument& e) {
+        book_details[3].assignTo(year);
+        int publicationYear;
+        if (!parseInt(year.data(), year.length(), publicationYear)) { // Convert year to integer
             continue;
-        } 
+        }
+        Book* newBook = new Book(title, author, isbn, publicationYear); // Create a new Book object with the parsed data
         
-        categoryNode->books.push_back(newBook); // Add the new book to the category node's books vector
-        libTree->updateBookCount(categoryNode, 1); // Update the book count in the category node and its parent nodes
+        libTree->attachBook(categoryNode, newBook); // Add the new book to the category node, the book counts and the indexes
         count++; // Increment the counter for each book imported
     }
 
     infile.close(); // Close the infile
+    libTree->endBulkLoad(); // Compute the book counts of all the categories
 
     cout << COLOR_GREEN << count << " books imported successfully." << COLOR_RESET << endl; // Print the number of books imported
 
     return 0; // Return 0 to indicate success
 }
 
+// A line of an imported file, parsed by a worker thread of importParallel
+struct ImportRecord {
+    bool complete;          // False if the line has less than 5 fields ("Incomplete book details")
+    string title, author, isbn, category;
+    bool yearOk;            // False if the year is not a number (the line is skipped)
+    int year;
+    Book* book;             // Book built for the line, nullptr if the line is incomplete or its year is not a number
+};
+
+// This method parses the lines [begin, end) of a file into records (empty lines produce no record)
+static void parseRecords(const char* begin, const char* end, MyVector<ImportRecord>& records) {
+    CSVField book_details[5];
+    CSVScanner scanner(begin, end);
+    int fieldCount;
+    string year;
+    while (scanner.nextLine(book_details, 5, fieldCount)) {
+        ImportRecord& record = records.emplace_back(); // Filled in place, its strings are never copied
+        record.complete = fieldCount >= 5;
+        record.yearOk = false;
+        record.year = 0;
+        record.book = nullptr;
+        if (record.complete) {
+            book_details[0].assignTo(record.title);
+            book_details[1].assignTo(record.author);
+            book_details[2].assignTo(record.isbn);
+            book_details[4].assignTo(record.category);
+            book_details[3].assignTo(year);
+            record.yearOk = parseInt(year.data(), year.length(), record.year);
+        }
+    }
+}
+
+// This method imports the lines [begin, end) of a file using several threads, it returns the number of books imported
+// The file is split at line breaks into chunks of about a megabyte. The worker threads parse the chunks in file order and
+// build their books, while this thread merges the chunks already parsed, also in file order: it resolves (and creates)
+// the categories, checks the duplicates against the catalog and the previous lines, prints the messages and attaches the
+// books, exactly as a sequential import does. The workers stay at most 2 chunks per thread ahead of the merge, so only
+// those chunks are held in memory, whatever the size of the file
+// The merge is the serial part of the import: it bounds the speedup, however many threads parse
+int LCMS::importParallel(const char* begin, const char* end, int threads) {
+    int chunkCount = max((long)threads * 4, (long)((end - begin) / IMPORT_CHUNK_BYTES) + 1);
+    MyVector<const char*> bounds;
+    bounds.push_back(begin);
+    for (int c = 1; c < chunkCount; c++) {
+        const char* pos = begin + (end - begin) * (long)c / chunkCount;
+        if (pos < bounds.back()) {
+            pos = bounds.back();
+        }
+        const char* lineEnd = (const char*)memchr(pos, '\n', end - pos);
+        bounds.push_back(lineEnd == nullptr ? end : lineEnd + 1); // Chunks start at the beginning of a line
+    }
+    bounds.push_back(end);
+
+    // A worker builds the books of the chunks it parsed: it normalizes the fields first, then interns the authors and
+    // takes the memory of the books with one lock of each pool for the whole chunk, instead of three locks per book
+    auto buildBooks = [](MyVector<ImportRecord>& records) {
+        MyVector<ImportRecord*> built;
+        for (int i = 0; i < records.size(); i++) {
+            if (records[i].complete && records[i].yearOk) {
+                built.push_back(&records[i]);
+            }
+        }
+        int n = built.size();
+        if (n == 0) {
+            return;
+        }
+        MyVector<string> authorKeys(n);
+        MyVector<const string*> authors(2 * n); // The authors, then the normalized authors
+        for (int i = 0; i < n; i++) {
+            authorKeys.push_back(normalize_key(built[i]->author));
+            authors.push_back(&built[i]->author);
+        }
+        for (int i = 0; i < n; i++) {
+            authors.push_back(&authorKeys[i]);
+        }
+        MyVector<const string*> interned(2 * n);
+        MyVector<void*> slots(n);
+        for (int i = 0; i < 2 * n; i++) {
+            interned.push_back(nullptr);
+        }
+        for (int i = 0; i < n; i++) {
+            slots.push_back(nullptr);
+        }
+        Book::authorPool.internAll(authors.data(), 2 * n, interned.data());
+        Book::pool.allocate(slots.data(), n);
+        for (int i = 0; i < n; i++) {
+            ImportRecord* record = built[i];
+            string titleKey = normalize_key(record->title);
+            // The title and the ISBN are copied, the merge still reports and checks the line with them
+            record->book = ::new (slots[i]) Book(record->title, interned[i], record->isbn, record->year, move(titleKey), interned[n + i]);
+        }
+    };
+
+    MyVector<ImportRecord>* chunks = new MyVector<ImportRecord>[chunkCount];
+    bool* parsed = new bool[chunkCount]();
+    int merged = 0;         // Number of chunks merged, the workers do not parse beyond merged + window
+    int window = 2 * threads;
+    mutex progress;
+    condition_variable chunkParsed, chunkMerged;
+    atomic<int> next(0);
+    MyVector<thread*> workers;
+    for (int t = 0; t < threads; t++) {
+        workers.push_back(new thread([&]() {
+            for (int c = next++; c < chunkCount; c = next++) {
+                {
+                    unique_lock<mutex> guard(progress);
+                    chunkMerged.wait(guard, [&] { return c < merged + window; });
+                }
+                parseRecords(bounds[c], bounds[c + 1], chunks[c]);
+                buildBooks(chunks[c]);
+                lock_guard<mutex> guard(progress);
+                parsed[c] = true;
+                chunkParsed.notify_all();
+            }
+        }));
+    }
+
+    unordered_map<string, Node*> resolved; // Categories already seen by the import, by name
+    int count = 0;
+    for (int c = 0; c < chunkCount; c++) {
+        {
+            unique_lock<mutex> guard(progress);
+            chunkParsed.wait(guard, [&] { return parsed[c]; });
+        }
+        for (int i = 0; i < chunks[c].size(); i++) {
+            ImportRecord& record = chunks[c][i];
+            if (!record.complete) {
+                cerr << COLOR_RED << "Incomplete book details" << COLOR_RESET << endl;
+                continue;
+            }
+            unordered_map<string, Node*>::iterator it = resolved.find(record.category);
+            if (it == resolved.end()) {
+                Node* categoryNode = libTree->getNode(record.category); // Get the category node from the tree
+                if (categoryNode == nullptr) { // If the category node does not exist
+                    categoryNode = libTree->createNode(record.category); // Create a new category node in the tree
+                }
+                it = resolved.insert(make_pair(record.category, categoryNode)).first;
+            }
+            // Check for duplicate book in the catalog (by ISBN) or in the category, the previous lines are attached already
+            if (libTree->containsBook(it->second, record.title, record.author, record.isbn)) {
+                cout << COLOR_RED << "The book \"" << record.title << "\" by " << record.author << " already exists in the catalog." << COLOR_RESET << endl;
+                delete record.book;
+                continue;
+            }
+            if (record.yearOk) { // Otherwise the line is skipped
+                libTree->attachBook(it->second, record.book); // Add the new book to the category node and the indexes
+                count++;
+            }
+        }
+        chunks[c] = MyVector<ImportRecord>(); // Free the records of the chunk
+        lock_guard<mutex> guard(progress);
+        merged++;
+        chunkMerged.notify_all();
+    }
+
+    for (int t = 0; t < workers.size(); t++) {
+        workers[t]->join();
+        delete workers[t];
+    }
+    delete[] parsed;
+    delete[] chunks;
+    return count;
+}
+
 // This method export data from the library to a file located at the given path
 void LCMS::exportData(string path) {
+    if (readOnly("export")) {
+        return;
+    }
     ofstream outfile(path); // Open the file for writing at the given path
     if (!outfile.is_open()) { // Check if the outfile is open
         cerr << COLOR_RED << "Could not open file " << path << COLOR_RESET << endl; // Print an error message if the file opening fails
         return; 
     }
 
-    outfile << "Title,Author,ISBN,Year,Category" << endl; // Write the header line to the file
+    auto start = chrono::steady_clock::now();
+    outfile << "Title,Author,ISBN,Year,Category\n"; // Write the header line to the file
 
     int count = libTree->exportData(libTree->getRoot(), outfile); // Export data from the root node of the tree
 
-    outfile.close(); // Close the outfile
+    double megabytes = (double)outfile.tellp() / (1 << 20);
+    outfile.close(); // Close the outfile (the last write reaches the file here)
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
 
     cout << COLOR_GREEN << count << " books exported successfully to " << path << COLOR_RESET << endl;
+    ios::fmtflags flags = cout.flags();
+    streamsize precision = cout.precision();
+    cout << fixed << setprecision(2) << megabytes << " MB written in " << seconds * 1000 << " ms ("
+         << (seconds > 0 ? megabytes / seconds : 0.0) << " MB/s)" << endl; // Print the export throughput
+    cout.flags(flags);
+    cout.precision(precision);
+}
+
+// This method saves the library to a binary snapshot file, read back by load
+void LCMS::save(string path) {
+    if (readOnly("save")) {
+        return;
+    }
+    if (path.empty()) { // If no file is provided
+        cout << COLOR_RED << "No file provided. Please enter a file name." << COLOR_RESET << endl; // Print an error message
+        return;
+    }
+    string error;
+    int count = libTree->saveSnapshot(path, error); // Write the snapshot of the whole tree
+    if (count < 0) {
+        cerr << COLOR_RED << "Could not save the catalog: " << error << COLOR_RESET << endl; // Print an error message if the saving fails
+        return;
+    }
+    cout << COLOR_GREEN << count << " books saved successfully to " << path << COLOR_RESET << endl;
+}
+
+// This method loads a binary snapshot file (written by save) into the library
+// The library must be empty, a snapshot replaces a whole catalog
+void LCMS::load(string path) {
+    if (path.empty()) { // If no file is provided
+        cout << COLOR_RED << "No file provided. Please enter a file name." << COLOR_RESET << endl; // Print an error message
+        return;
+    }
+    if (readOnly("load")) {
+        return;
+    }
+    auto start = chrono::steady_clock::now();
+    string error;
+    int count = libTree->loadSnapshot(path, error); // Rebuild the tree from the snapshot
+    if (count < 0) {
+        cerr << COLOR_RED << "Could not load " << path << ": " << error << COLOR_RESET << endl; // Print an error message if the loading fails
+        return;
+    }
+    double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+    cout << COLOR_GREEN << count << " books loaded successfully from " << path << COLOR_RESET << endl;
+    ios::fmtflags flags = cout.flags();
+    streamsize precision = cout.precision();
+    cout << "Loaded in " << fixed << setprecision(2) << ms << " ms" << endl; // Print the loading time
+    cout.flags(flags);
+    cout.precision(precision);
 }
 
 // Method to find all books and categories containing the keyword
 // It takes a keyword as input and searches for it in the library
 void LCMS::find(string keyword) {
+    // "find <keyword> --top N" ranks the matching books and only lists the N best ones
+    size_t option = keyword.rfind("--top");
+    if (option != string::npos && (option == 0 || keyword[option - 1] == ' ')) {
+        string count = strip_whitespace(keyword.substr(option + 5));
+        if (count.empty() || count.length() > 6 || count.find_first_not_of("0123456789") != string::npos || stoi(count) == 0) {
+            cout << COLOR_RED << "Invalid value for --top. Please enter a positive number of books." << COLOR_RESET << endl; // Print an error message
+            return;
+        }
+        findTop(strip_whitespace(keyword.substr(0, option)), stoi(count));
+        return;
+    }
+
+    if (snapshot != nullptr) { // Served from the snapshot
+        findSnapshot(keyword);
+        return;
+    }
+
     MyVector<Node*> categoriesFound; // Vector to store found categories
     MyVector<Book*> booksFound; // Vector to store found books
 
@@ -143,7 +457,7 @@ void LCMS::find(string keyword) {
     if (categoriesFound.size() > 0) {
         cout << "List of categories containing <" << keyword << ">:" << endl;
         for (int i = 0; i < categoriesFound.size(); i++) {
-            cout << i+1 << ". " << categoriesFound[i]->name << endl; // Print the names of found categories
+            cout << i+1 << ". " << *categoriesFound[i]->name << endl; // Print the names of found categories
         }
         cout << "========================================" << endl; // Print a separator line 
     }
@@ -157,9 +471,81 @@ void LCMS::find(string keyword) {
     }
 }
 
+// Method to find all books and categories containing the keyword, in the snapshot opened read-only
+// The strings are compared in place in the mapped file, in the order of the snapshot
+void LCMS::findSnapshot(string keyword) {
+    string keywordKey = normalize_key(keyword);
+    if (keywordKey.empty()) {
+        cout << "No keyword provid. Please enter a keyword" << endl;
+        return;
+    }
+    MyVector<uint32_t> categoriesFound; // Indices of the found categories
+    MyVector<uint32_t> booksFound; // Indices of the found books
+    snapshot->find(keywordKey, FUZZY_SEARCH_THRESHOLD, categoriesFound, booksFound);
+
+    cout << categoriesFound.size() << " categories found." << endl; // Print the number of categories found
+    cout << booksFound.size() << " books found." << endl; // Print the number of books found
+    cout << "----------------------------------------" << endl; // Print a separator line 
+
+    if (categoriesFound.size() > 0) {
+        cout << "List of categories containing <" << keyword << ">:" << endl;
+        for (int i = 0; i < categoriesFound.size(); i++) {
+            cout << i+1 << ". ";
+            snapshot->printName(categoriesFound[i]); // Print the names of found categories
+            cout << endl;
+        }
+        cout << "========================================" << endl; // Print a separator line 
+    }
+
+    // Print the details of found books
+    if (booksFound.size() > 0) {
+        cout << "List of books containing <" << keyword << ">:" << endl;
+        for (int i = 0; i < booksFound.size(); i++) {
+            snapshot->printBook(booksFound[i]); // Print the details of found books
+        }
+    }
+}
+
+// Method to find and display the count books best matching a keyword, best first
+// Exact matches of a title or an author come first, then prefixes, substrings and close misspellings
+void LCMS::findTop(string keyword, int count) {
+    if (readOnly("find --top")) {
+        return;
+    }
+    if (keyword.empty()) { // If no keyword is provided
+        cout << COLOR_RED << "No keyword provided. Please enter a keyword." << COLOR_RESET << endl; // Print an error message
+        return;
+    }
+    MyVector<ScoredBook> results; // Vector to store the best matches
+    libTree->findTop(keyword, count, results); // Rank the books of the whole catalog
+
+    cout << results.size() << " best matching books found." << endl; // Print the number of books found
+    cout << "----------------------------------------" << endl; // Print a separator line 
+    for (int i = 0; i < results.size(); i++) {
+        int score = results[i].score;
+        cout << i+1 << ". ";
+        if (score == 0) cout << "exact match";
+        else if (score == 1) cout << "prefix match";
+        else if (score == 2) cout << "substring match";
+        else cout << "fuzzy match (edit distance " << score - 2 << ")";
+        cout << ", score " << score << endl;
+        results[i].book->print(); // Print the details of the book
+    }
+}
+
 // Method to find and display all books under a specific category/subcategory
 // If no category is provided, it lists all books in the library
 void LCMS::findAll(string category) {
+    if (snapshot != nullptr) { // Served from the snapshot
+        uint32_t categoryNode = snapshot->getNode(category); // The root for an empty category
+        if (categoryNode == SNAPSHOT_NONE) {
+            cout << COLOR_RED << "Category \"" << category << "\" not found in the library catalog" << COLOR_RESET << endl; // Print an error message
+            return;
+        }
+        uint32_t count = snapshot->printAll(categoryNode);
+        cout << count << " books found" << endl;
+        return;
+    }
     if (category == "") { // If no category is provided
         libTree->printAll(libTree->getRoot()); // Print all books from the root node (entire library)
         cout << libTree->getRoot()->bookCount << " books found" << endl;
@@ -176,6 +562,10 @@ void LCMS::findAll(string category) {
 
 // Method to list all categories and books in the library
 void LCMS::list() {
+    if (snapshot != nullptr) {
+        snapshot->print(); // Display the category tree of the snapshot
+        return;
+    }
     libTree->print(); // Call the print method on the tree to display all categories and books
 }
 
@@ -186,16 +576,109 @@ void LCMS::findBook(string bookTitle) {
         cout << COLOR_RED << "No title provided. Please enter a book title." << COLOR_RESET << endl; // Print an error message
         return; 
     }
+    if (snapshot != nullptr) { // Served from the snapshot
+        uint32_t book = snapshot->findBook(normalize_key(bookTitle), FUZZY_SEARCH_THRESHOLD);
+        if (book == SNAPSHOT_NONE) {
+            cout << COLOR_RED << bookTitle << " not found." << COLOR_RESET << endl; // Print an error message
+            return;
+        }
+        cout << "Book found in the library: " << endl;
+        cout << "-------------------------" << endl;
+        snapshot->printBook(book);
+        return;
+    }
     Node* StartNode= libTree->getRoot(); // Start from the root node
     Book* foundBook = libTree->findBook(StartNode, bookTitle); // Call the findBook method on the root node
 
     if (foundBook == nullptr) { // If the book is not found
         cout << COLOR_RED << bookTitle << " not found." << COLOR_RESET << endl; // Print an error message
     }
+
+    // When the title is not an exact match, the suggestion dictionary (if built) provides a ranked "did you mean" list
+    if (libTree->getDictionary() != nullptr && (foundBook == nullptr || foundBook->titleKey != normalize_key(bookTitle))) {
+        MyVector<BKMatch> suggestions;
+        libTree->suggestTitles(normalize_key(bookTitle), 5, suggestions);
+        if (suggestions.size() > 0) {
+            cout << "Did you mean:" << endl;
+            for (int i = 0; i < suggestions.size(); i++) {
+                cout << i+1 << ". " << suggestions[i].book->title << " by " << *suggestions[i].book->author << endl;
+            }
+        }
+    }
+}
+
+// Method to find a book by its ISBN, the ISBN-10 and ISBN-13 forms of an ISBN find the same book
+void LCMS::findIsbn(string isbn) {
+    if (readOnly("findIsbn")) {
+        return;
+    }
+    if (isbn.empty()) { // If no ISBN is provided
+        cout << COLOR_RED << "No ISBN provided. Please enter an ISBN." << COLOR_RESET << endl; // Print an error message
+        return;
+    }
+    uint64_t isbnKey = Book::normalizeIsbn(isbn);
+    if (isbnKey == 0) {
+        cout << COLOR_RED << isbn << " is not a valid ISBN-10 or ISBN-13." << COLOR_RESET << endl;
+        return;
+    }
+    BookRef found = libTree->findIsbn(isbnKey); // Looked up in the ISBN index
+    if (found.book == nullptr) {
+        cout << COLOR_RED << isbn << " not found." << COLOR_RESET << endl;
+        return;
+    }
+    cout << "Book found in the library, in " << libTree->categoryPath(found.node) << ": " << endl;
+    cout << "-------------------------" << endl;
+    found.book->print();
+}
+
+// Method to build the suggestion dictionary used for "did you mean" corrections
+// It trades memory for latency, so it is only built on request and its memory usage is reported
+void LCMS::buildDictionary() {
+    if (readOnly("buildDictionary")) {
+        return;
+    }
+    auto start = chrono::steady_clock::now();
+    libTree->buildDictionary();
+    double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+
+    const SuggestionDictionary* dictionary = libTree->getDictionary();
+    ios::fmtflags flags = cout.flags();
+    streamsize precision = cout.precision();
+    cout << COLOR_GREEN << "Suggestion dictionary built for " << dictionary->size() << " titles (" 
+         << dictionary->variants() << " deletion variants) in " << fixed << setprecision(2) << ms << " ms." << COLOR_RESET << endl;
+    cout << "Estimated memory usage: " << dictionary->memoryUsage() / (1024.0 * 1024.0) << " MB" << endl;
+    cout.flags(flags);
+    cout.precision(precision);
+}
+
+// Method to display the size of the catalog and what the interning pools hold
+// Every book references its author and normalized author, and every category its name and normalized name
+void LCMS::stats() {
+    if (readOnly("stats")) {
+        return;
+    }
+    StringPool& authors = Book::getAuthorPool();
+    StringPool& names = Node::getNamePool();
+
+    cout << "Books      : " << libTree->getRoot()->bookCount << endl;
+    cout << "Categories : " << libTree->getCategoryCount() << endl;
+    cout << "Authors    : " << authors.referenceCount() << " references to " << authors.distinctCount() << " distinct strings, "
+         << authors.storedBytes() << " bytes stored, " << COLOR_GREEN << authors.savedBytes() << " bytes saved" << COLOR_RESET << endl;
+    cout << "Names      : " << names.referenceCount() << " references to " << names.distinctCount() << " distinct strings, "
+         << names.storedBytes() << " bytes stored, " << COLOR_GREEN << names.savedBytes() << " bytes saved" << COLOR_RESET << endl;
+    ios::fmtflags flags = cout.flags();
+    streamsize precision = cout.precision();
+    cout << "Total saved by string interning: " << fixed << setprecision(2)
+         << (authors.savedBytes() + names.savedBytes()) / (1024.0 * 1024.0) << " MB" << endl;
+    cout.flags(flags);
+    cout.precision(precision);
 }
 
 // Method to add a new book to the library
 Book* LCMS::addBook() {
+    if (readOnly("addBook")) {
+        return nullptr;
+    }
     string title, author, isbn, year, category; // Variables to store book details
 
     // Prompt and read book details [title, author, isbn, publication_year, and category] from user
@@ -250,18 +733,13 @@ Book* LCMS::addBook() {
     }
 
     // Check for duplicate book in the category
-    for (int i = 0; i < categoryNode->books.size(); i++) {
-        Book* book = categoryNode->books[i];
-        if (book->title == title && book->author == author && book->isbn == isbn) {
-            cout << COLOR_RED << "The book \"" << title << "\" by " << author << " already exists in the catalog." << COLOR_RESET << endl;
-            return nullptr; // Skip adding the book if already exists
-        }
+    if (libTree->containsBook(categoryNode, title, author, isbn)) {
+        cout << COLOR_RED << "The book \"" << title << "\" by " << author << " already exists in the catalog." << COLOR_RESET << endl;
+        return nullptr; // Skip adding the book if already exists
     }
     int publicationYear = stoi(year); // Convert year to integer
     Book* newBook = new Book(title, author, isbn, publicationYear); // Create a new Book
-    categoryNode->books.push_back(newBook); // Add the new book to the category node's books vector
-
-    libTree->updateBookCount(categoryNode, 1); // Update the book count in the category node and its parent nodes
+    libTree->attachBook(categoryNode, newBook); // Add the new book to the category node, the book counts and the indexes
     cout << COLOR_GREEN << title << " has been successfully added into the catalog." << COLOR_RESET << endl; // Print a success message
     return newBook ; // Return the title of the added book
 }
@@ -273,6 +751,9 @@ void LCMS:: addBook(Book* book, const string category) {
         cout << COLOR_RED << "No book provided. Please provide a valid book." << COLOR_RESET << endl; // Print an error message
         return; 
     }
+    if (readOnly("addBook")) {
+        return;
+    }
     Node* categoryNode = libTree->getNode(category); // Get the category node from the tree
 
     if (categoryNode == nullptr) { // If the category node does not exist
@@ -281,20 +762,19 @@ void LCMS:: addBook(Book* book, const string category) {
     }
 
     // Check for duplicate book in the category
-    for (int i = 0; i < categoryNode->books.size(); i++) {
-        Book* existingBook = categoryNode->books[i];
-        if (existingBook->title == book->title && existingBook->author == book->author && existingBook->isbn == book->isbn) {
-            cout << COLOR_RED << "The book \"" << book->title << "\" by " << book->author << " already exists in the catalog." << COLOR_RESET << endl;
-            return; // Skip adding the book if already exists
-        }
+    if (libTree->containsBook(categoryNode, book->title, *book->author, book->isbn)) {
+        cout << COLOR_RED << "The book \"" << book->title << "\" by " << *book->author << " already exists in the catalog." << COLOR_RESET << endl;
+        return; // Skip adding the book if already exists
     }
     
-    categoryNode->books.push_back(book); // Add the new book to the category node's books vector
-    libTree->updateBookCount(categoryNode, 1); // Update the book count in the category node and its parent nodes
+    libTree->attachBook(categoryNode, book); // Add the book to the category node, the book counts and the indexes
 }
 
 // Method to edit the details of an existing book by its title
 void LCMS::editBook(string bookTitle) {
+    if (readOnly("editBook")) {
+        return;
+    }
     if (bookTitle == "") { // If no book title is provided
         cout << COLOR_RED << "No title provided. Please enter a book title." << COLOR_RESET << endl; // Print an error message
         return; 
@@ -308,6 +788,7 @@ void LCMS::editBook(string bookTitle) {
     }
 
     string newTitle, newAuthor, newISBN, newYear; // Variables to store new book details
+    Book* isbnOwner = nullptr; // Book of the catalog already using a new ISBN
     bool quit = true; // Flag to track if the user wants to quit
     do {
         // display the options for editing
@@ -335,7 +816,7 @@ void LCMS::editBook(string bookTitle) {
                         cout << COLOR_RED << "Title cannot be empty. Please enter a valid title." << COLOR_RESET << endl;
                     }
                 } while (newTitle.empty()); // Prompt until a valid title is provided
-                foundBook->title = newTitle; // Update the book title
+                libTree->retitleBook(foundBook, newTitle); // Update the book title (and its search key and index entry)
                 break;
             case 2:
                 do {
@@ -345,7 +826,7 @@ void LCMS::editBook(string bookTitle) {
                         cout << COLOR_RED << "Author cannot be empty. Please enter a valid author name." << COLOR_RESET << endl;
                     }
                 } while (newAuthor.empty()); // Prompt until a valid author name is provided
-                foundBook->author = newAuthor; // Update the book author
+                libTree->reauthorBook(foundBook, newAuthor); // Update the book author (and its search key and index entry)
                 break;
             case 3:
                 do {
@@ -355,7 +836,12 @@ void LCMS::editBook(string bookTitle) {
                         cout << COLOR_RED << "ISBN cannot be empty. Please enter a valid ISBN." << COLOR_RESET << endl;
                     }
                 } while (newISBN.empty()); // Prompt until a valid ISBN is provided
-                foundBook->isbn = newISBN; // Update the book ISBN
+                isbnOwner = libTree->findIsbn(Book::normalizeIsbn(newISBN)).book; // ISBNs are unique in the catalog
+                if (isbnOwner != nullptr && isbnOwner != foundBook) {
+                    cout << COLOR_RED << "The ISBN " << newISBN << " is already used by another book of the catalog." << COLOR_RESET << endl;
+                    break;
+                }
+                libTree->changeIsbn(foundBook, newISBN); // Update the book ISBN (and its normalized key and index entry)
                 break;
             case 4:
                 do {
@@ -366,7 +852,7 @@ void LCMS::editBook(string bookTitle) {
                     continue;
                     }
                     try {
-                    foundBook->publication_year = stoi(newYear); // Update the book publication year if valid
+                    libTree->changeYear(foundBook, stoi(newYear)); // Update the book publication year if valid
                     break;
                     } 
                     catch (const invalid_argument&) {
@@ -387,6 +873,9 @@ void LCMS::editBook(string bookTitle) {
 // Method to remove a book from the library by its title
 // Removes a book from the catalog by its title after confirming with the user.
 void LCMS::removeBook(string bookTitle, Book*& removedBook, string& removedBookCategory) {
+    if (readOnly("removeBook")) {
+        return;
+    }
     if (bookTitle == "") { // If no book title is provided
         cout << COLOR_RED << "No book title provided. Please enter a book title." << COLOR_RESET << endl; // Print an error message
         return; 
@@ -405,7 +894,7 @@ void LCMS::removeBook(string bookTitle, Book*& removedBook, string& removedBookC
     cin.ignore(); // Ignore leftover '\n'
 
     if (choice == 'y' || choice == 'Y') { // If user confirms removal
-        if (libTree->removeBook(StartNode, bookTitle, removedBook, removedBookCategory)) { // Call the removeBook method on the root node
+        if (libTree->removeBook(foundBook, removedBook, removedBookCategory)) { // Remove the book found above, without searching again
         cout << COLOR_GREEN << "\"" << bookTitle << "\" has been deleted from the library catalog." << COLOR_RESET << endl; // Print a success message
         
         } else {
@@ -424,6 +913,18 @@ void LCMS::findCategory(string category) {
         return; 
     }
     
+    if (snapshot != nullptr) { // Served from the snapshot
+        uint32_t categoryNode = snapshot->getNode(category);
+        if (categoryNode == SNAPSHOT_NONE) {
+            cout << COLOR_RED << " No such category found in the library catalog." << COLOR_RESET << endl; // Print an error message
+            return;
+        }
+        cout << COLOR_GREEN << "Category '";
+        snapshot->printName(categoryNode);
+        cout << "' was found in the library catalog." << COLOR_RESET << endl; // Print the name of the found category
+        return;
+    }
+
     Node* categoryNode = libTree->getNode(category); // Get the category node from the tree
 
     if (categoryNode == nullptr) { // If the category node does not exist
@@ -431,11 +932,14 @@ void LCMS::findCategory(string category) {
         return; 
     }
 
-    cout << COLOR_GREEN << "Category '" << categoryNode->name << "' was found in the library catalog." << COLOR_RESET << endl; // Print the name of the found category
+    cout << COLOR_GREEN << "Category '" << *categoryNode->name << "' was found in the library catalog." << COLOR_RESET << endl; // Print the name of the found category
 }
 
 // Method to add a new category to the library
 void LCMS::addCategory(string category) {
+    if (readOnly("addCategory")) {
+        return;
+    }
     if (category == "") { // If no category name is provided
         cout << COLOR_RED << "No category name provided. Please enter a category name." << COLOR_RESET << endl; // Print an error message
         return; 
@@ -453,6 +957,9 @@ void LCMS::addCategory(string category) {
 
 // Method to edit the name of an existing category
 void LCMS::editCategory(string category) {
+    if (readOnly("editCategory")) {
+        return;
+    }
     if (category == "") { // If no category name is provided
         cout << COLOR_RED << "No category name provided. Please enter a category name." << COLOR_RESET << endl; // Print an error message
         return; 
@@ -473,12 +980,18 @@ void LCMS::editCategory(string category) {
         }
     } while (newCategoryName.empty()); // Prompt until a valid category name is provided
 
-    categoryNode->name = newCategoryName; // Update the category name
+    if (!libTree->renameNode(categoryNode, newCategoryName)) { // Update the category name (and its search keys)
+        cout << COLOR_RED << "Category " << newCategoryName << " already exists." << COLOR_RESET << endl; // Print an error message
+        return; 
+    }
     cout << COLOR_GREEN << "Category name updated successfully." << COLOR_RESET << endl; // Print a success message
 }
 
 // Method to remove a category (and its subcategories/books) from the library
 void LCMS::removeCategory(string category) {
+    if (readOnly("removeCategory")) {
+        return;
+    }
     if (category == "") { // If no category name is provided
         cout << COLOR_RED << "No category name provided. Please enter a category name." << COLOR_RESET << endl; // Print an error message
         return; 
@@ -490,7 +1003,7 @@ void LCMS::removeCategory(string category) {
         return; 
     }
 
-    libTree->removeChild(categoryNode->parent, categoryNode->name); // Call the removeChild method on the parent node to remove the category
+    libTree->removeChild(categoryNode->parent, *categoryNode->name); // Call the removeChild method on the parent node to remove the category
 }
 //==========================================================================
 // End of the file
@@ -2,12 +2,23 @@
 #define _LCMS_H
 
 #include "tree.h"
+#include "snapshot.h"
 
 // Class representing a Library Content Management System (LCMS)
 class LCMS 
 {
 	private:
 	    Tree* libTree;  // Pointer to the Tree structure that represents the library's hierarchical organization
+	    SnapshotView* snapshot; // Read-only snapshot serving the queries instead of the Tree (nullptr unless opened)
+
+	    // Helper method to reject a command that needs the Tree while a snapshot is open, returns true if rejected
+	    bool readOnly(const string& command);
+
+	    // Helper method to serve find from the snapshot
+	    void findSnapshot(string keyword);
+
+	    // Helper method to import the lines [begin, end) of a file on several threads
+	    int importParallel(const char* begin, const char* end, int threads);
 
 	public:
 	    // Constructor to initialize the LCMS with a root category name (Library)
@@ -16,15 +27,28 @@ class LCMS
 	    // Destructor to clean up resources (e.g., delete the Tree)
 	    ~LCMS();
 
-	    // Method to import data from a file located at the given path
+	    // Method to import data from a file located at the given path ("<path> --threads N" to set the number of threads)
 	    int import(string path);
 
 	    // Method to export the library data to a file located at the given path
 	    void exportData(string path);
 
+	    // Method to save the library to a binary snapshot file
+	    void save(string path);
+
+	    // Method to load a binary snapshot file into the (empty) library
+	    void load(string path);
+
+	    // Method to open a snapshot file read-only: find, findBook, findAll, findCategory and list are served from the
+	    // mapped file and every other command is rejected
+	    void open(string path);
+
 	    // Method to find all books and categories containing the keyworkd
 	    void find(string keyword);
 
+	    // Method to find and display the count books best matching a keyword, ranked by match quality
+	    void findTop(string keyword, int count);
+
 	    // Method to find and display all books under a specific category/subcategory
 	    void findAll(string category);
 
@@ -33,6 +57,15 @@ class LCMS
 
 	  	// Method to find and display details of a book by its title
 	    void findBook(string bookTitle);
+
+	    // Method to find and display details of a book by its ISBN (ISBN-10 or ISBN-13, hyphens allowed)
+	    void findIsbn(string isbn);
+
+	    // Method to build the suggestion dictionary used for "did you mean" corrections, and report its memory usage
+	    void buildDictionary();
+
+	    // Method to display the size of the catalog and the memory saved by interning the author and category strings
+	    void stats();
  		
  		// Method to add a new book to the library, and return the pointer to the added book
 	    Book* addBook();
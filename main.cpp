@@ -9,10 +9,18 @@ void listCommands()
         <<" Welcome to the Library Catalog Management System!\n"<<endl
         <<" List of available Commands:"<<endl
 		<<" import <file_name>                          : Read a Book file from a file"<<endl
+		<<" import <file_name> --threads <N>            : Read a Book file using N threads (at most 16, default: all cores for large files)"<<endl
 		<<" export <file_name>                          : Export Books to a file"<<endl
+		<<" save <file_name>                            : Save the catalog to a binary snapshot file"<<endl
+		<<" load <file_name>                            : Load a binary snapshot file into an empty catalog"<<endl
+		<<" open <file_name>                            : Serve queries read-only from a snapshot file (empty catalog only)"<<endl
 		<<" find <keyword>                              : List all books and categories containing the <keyword>"<<endl
+		<<" find <keyword> --top <N>                    : List the N books best matching the <keyword>, ranked"<<endl
 		<<" findBook <title of the book>                : Search a book in the catalog"<<endl
+		<<" findIsbn <isbn>                             : Search a book in the catalog by its ISBN-10 or ISBN-13"<<endl
 		<<" findAll <category/sub-category/..>          : List all books in a category/sub-category"<<endl
+		<<" buildDictionary                             : Build the \"did you mean\" dictionary of titles (uses extra memory)"<<endl
+		<<" stats                                       : Display catalog statistics (memory saved by string interning)"<<endl
 		<<" addBook <book-title>                        : Add a book to the catalog"<<endl
 		<<" editBook <book-title>                       : Edit a book detail in the catalog"<<endl
 		<<" removeBook <book-title>                     : Remove a book from the catalog"<<endl
@@ -58,14 +66,26 @@ int main()
 			    lcms.import(parameter1); 
 			else if(command=="export")    	    							
 				lcms.exportData(parameter1);
+			else if(command=="save")
+				lcms.save(parameter1);
+			else if(command=="load")
+				lcms.load(parameter1);
+			else if(command=="open")
+				lcms.open(parameter1);
 			else if(command=="list")										
 				lcms.list();
 			else if(command=="find") 						     			
 				lcms.find(parameter1);
 			else if(command=="findBook" or command=="findbook" or command == "fb")				
 				lcms.findBook(parameter1);
+			else if(command=="findIsbn" or command=="findisbn" or command == "fi")
+				lcms.findIsbn(parameter1);
 			else if(command=="findAll" or command=="findall" or command == "fa")     			
 				lcms.findAll(parameter1);
+			else if(command=="buildDictionary" or command=="builddictionary" or command == "bd")
+				lcms.buildDictionary();
+			else if(command=="stats")
+				lcms.stats();
 			else if(command=="addBook" or command=="addbook" or command == "ab") {
 				ICommand* addBookCmd = static_cast<ICommand*>(new AddBook(&lcms));  // Create a new AddBook command
 				if (addBookCmd) {
@@ -16,33 +16,94 @@
 #include <iomanip>
 #include <stdexcept>
 #include <sstream>
+#include <new>
+#include <utility>
 
 using namespace std;
 
-// Template class for a custom vector implementation
+// Inline storage for the first N elements of a MyVector
+// It is a base class of the vector, so that it takes no space at all when N is 0 (empty base)
+template <typename T, int N>
+struct MyVectorInline
+{
+	    alignas(T) unsigned char buffer[N * sizeof(T)];   // Uninitialized slots of the first N elements
+	    T* slots() { return reinterpret_cast<T*>(buffer); }
+	    const T* slots() const { return reinterpret_cast<const T*>(buffer); }
+};
+
 template <typename T>
-class MyVector 
+struct MyVectorInline<T, 0>
+{
+	    T* slots() { return nullptr; }
+	    const T* slots() const { return nullptr; }
+};
+
+// Template class for a custom vector implementation
+// The elements live in raw (uninitialized) storage: a slot is only constructed when an element is put in it,
+// and the elements are moved, not copied, when the storage grows
+// With N > 0, the first N elements are stored inside the vector object itself: a vector that never holds more
+// than N elements never allocates, and its elements sit next to the object that owns the vector
+template <typename T, int N = 0>
+class MyVector : private MyVectorInline<T, N>
 {
 	private:
-	    T *array;                // Pointer to dynamically allocated array to store elements
+	    T *array;                // Storage of the elements: the inline slots, or an allocated array (only the first v_size are constructed)
 	    int v_size;             // Current number of elements in the vector
-	    int v_capacity;         // Total capacity of the vector (size of the allocated array)
+	    int v_capacity;         // Total capacity of the vector (N while the inline slots are used)
+
+	    // Helper methods to allocate/free uninitialized storage, and to move the elements to a new storage of n slots
+	    static T* allocate(int n);
+	    static void deallocate(T* storage);
+	    void reallocate(int n);
+
+	    // Helper methods to check if the inline slots are in use, and to free the storage unless it is the inline one
+	    bool isInline() const { return array == this->slots(); }
+	    void release();
+
+	    // Helper method to take the elements of other (which is left empty), this vector must be empty and inline
+	    void takeFrom(MyVector& other) noexcept;
 
 	public:
+	    // Types of the elements and of the iterators (the elements are contiguous, so a pointer is a random-access iterator)
+	    typedef T value_type;
+	    typedef T* iterator;
+	    typedef const T* const_iterator;
+
 	    // Constructors and Destructor
-	    MyVector();                     // Default constructor (initializes an empty vector)
+	    MyVector();                     // Default constructor (initializes an empty vector, on its inline slots if any)
 	    MyVector(int cap);              // Constructor with initial capacity
+	    MyVector(const MyVector& other);        // Copy constructor (copies the elements)
+	    MyVector(MyVector&& other) noexcept;    // Move constructor (takes over the storage of other, moves inline elements)
 	    ~MyVector();                    // Destructor (deallocates memory)
 
+	    // Assignment operators
+	    MyVector& operator=(const MyVector& other);     // Copy assignment
+	    MyVector& operator=(MyVector&& other) noexcept; // Move assignment
+
 	    // Vector Operations
-	    void push_back(T element);      // Adds an element to the end of the vector
+	    void push_back(const T& element);   // Adds a copy of an element to the end of the vector
+	    void push_back(T&& element);        // Moves an element to the end of the vector
+	    template <typename... Args>
+	    T& emplace_back(Args&&... args);    // Constructs an element in place at the end of the vector
 	    void reserve(int n);            //increase the capacity of the vector so that it can hold at least n elements
         void insert(int index, T element); // Inserts an element at a specific index
 	    void erase(int index);          // Removes an element at a specific index
+	    void clear();                   // Removes all the elements (the capacity is kept)
 	    T& operator[](int index);       // Overloaded [] operator to access elements by index
+	    const T& operator[](int index) const;
 	    T& at(int index);               // Access element at a specific index with bounds checking
-	    const T& front();               // Returns a reference to the first element
-	    const T& back();                // Returns a reference to the last element
+	    T& front();                     // Returns a reference to the first element
+	    const T& front() const;
+	    T& back();                      // Returns a reference to the last element
+	    const T& back() const;
+	    T* data();                      // Returns a pointer to the first element (nullptr while nothing was allocated and N is 0)
+	    const T* data() const;
+
+	    // Iterators over the elements, usable with range-based for and the standard algorithms
+	    iterator begin() { return array; }
+	    iterator end() { return array + v_size; }
+	    const_iterator begin() const { return array; }
+	    const_iterator end() const { return array + v_size; }
 	    int size() const;               // Returns the current number of elements in the vector
 	    int capacity() const;           // Returns the current capacity of the vector
 	    bool empty() const;             // Checks if the vector is empty
@@ -59,88 +120,244 @@ class VectorEmpty : public runtime_error {
 		VectorEmpty() : runtime_error("Vector is Empty") {}
 };
 
+// This method allocates uninitialized storage for n elements
+template<typename T, int N>
+T* MyVector<T, N>::allocate(int n) {
+	if (n <= 0) {
+		return nullptr;
+	}
+	return static_cast<T*>(::operator new(sizeof(T) * (size_t)n));  //Raw memory, no element is constructed
+}
+
+// This method frees storage obtained from allocate (its elements must have been destroyed)
+template<typename T, int N>
+void MyVector<T, N>::deallocate(T* storage) {
+	::operator delete(storage);
+}
+
+// This method frees the storage of the elements, unless it is the inline one
+template<typename T, int N>
+void MyVector<T, N>::release() {
+	if (!isInline()) {
+		deallocate(array);
+	}
+}
+
+// This method moves the elements to a new storage of n slots (n >= v_size) and frees the old one
+// A storage of N slots or less is the inline one (the elements move back into the vector)
+// The elements are moved if their move constructor cannot throw, copied otherwise
+template<typename T, int N>
+void MyVector<T, N>::reallocate(int n) {
+	T *newArray = (n <= N) ? this->slots() : allocate(n);  //Uninitialized memory for newArray, with size n
+	if (newArray == array) {
+		return;  //Already on the inline slots
+	}
+	for (int i = 0; i < v_size; i++) {
+		new (newArray + i) T(move_if_noexcept(array[i]));  //Move elements from array to newArray
+		array[i].~T();
+	}
+	release();  //Free the old storage
+	array = newArray;  //Assign newArray to array
+	v_capacity = max(n, N);  //Update capacity of vector
+}
+
+// This method takes the elements of other and leaves it empty
+// An allocated storage is taken over as is, inline elements have to be moved one by one
+template<typename T, int N>
+void MyVector<T, N>::takeFrom(MyVector& other) noexcept {
+	if (other.isInline()) {
+		for (int i = 0; i < other.v_size; i++) {
+			new (array + i) T(move(other.array[i]));
+			other.array[i].~T();
+		}
+	} else {
+		array = other.array;
+		v_capacity = other.v_capacity;
+		other.array = other.slots();
+		other.v_capacity = N;
+	}
+	v_size = other.v_size;
+	other.v_size = 0;
+}
+
 //Constructor to initialize a vector with given capacity
-template<typename T>
-MyVector<T>::MyVector(int cap) : v_size(0), v_capacity(cap)
+template<typename T, int N>
+MyVector<T, N>::MyVector(int cap) : array(this->slots()), v_size(0), v_capacity(N)
 {
-	array = new T[v_capacity];  //Allocate memory for array
+	reserve(cap);  //Allocate memory for array, unless the inline slots are enough
 }	
 
 //Constructor to initialize an empty vector
-template<typename T>
-MyVector<T>::MyVector() : array(nullptr), v_size(0), v_capacity(0) {}	
+template<typename T, int N>
+MyVector<T, N>::MyVector() : array(this->slots()), v_size(0), v_capacity(N) {}	
+
+//Copy constructor, the new vector gets its own copy of the elements
+template<typename T, int N>
+MyVector<T, N>::MyVector(const MyVector& other) : array(this->slots()), v_size(0), v_capacity(N)
+{
+	reserve(other.v_size);
+	for (; v_size < other.v_size; v_size++) {
+		new (array + v_size) T(other.array[v_size]);
+	}
+}
+
+//Move constructor, the storage of other is taken over and other is left empty
+template<typename T, int N>
+MyVector<T, N>::MyVector(MyVector&& other) noexcept : array(this->slots()), v_size(0), v_capacity(N)
+{
+	takeFrom(other);
+}
 
 //Destructor
-template<typename T>
-MyVector<T>::~MyVector()
+template<typename T, int N>
+MyVector<T, N>::~MyVector()
 {
-	delete[] array;		//Deallocate memory
+	clear();		//Destroy the elements
+	release();		//Deallocate memory
+}
+
+//Copy assignment, it reuses the storage when it is large enough
+template<typename T, int N>
+MyVector<T, N>& MyVector<T, N>::operator=(const MyVector& other) {
+	if (this != &other) {
+		clear();
+		if (v_capacity < other.v_size) {
+			release();
+			array = this->slots();  //Left empty if the allocation below throws
+			v_capacity = N;
+			array = allocate(other.v_size);
+			v_capacity = other.v_size;
+		}
+		for (; v_size < other.v_size; v_size++) {
+			new (array + v_size) T(other.array[v_size]);
+		}
+	}
+	return *this;
+}
+
+//Move assignment, the current elements are destroyed and the storage of other is taken over
+template<typename T, int N>
+MyVector<T, N>& MyVector<T, N>::operator=(MyVector&& other) noexcept {
+	if (this != &other) {
+		clear();
+		release();
+		array = this->slots();
+		v_capacity = N;
+		takeFrom(other);
+	}
+	return *this;
 }
 
 // This method returns current size of vector	
-template<typename T>		
-int MyVector<T>::size() const {
+template<typename T, int N>
+int MyVector<T, N>::size() const {
 	return v_size;  //Return current size of vector
 }
 
 // This method returns capacity of vector
-template<typename T>
-int MyVector<T>::capacity() const {
+template<typename T, int N>
+int MyVector<T, N>::capacity() const {
 	return v_capacity;  //Return capacity of vector
 }
 
 // This method increase the capacity of the vector so that it can hold at least n elements
-template<typename T>
-void MyVector<T>::reserve(int n) {
+template<typename T, int N>
+void MyVector<T, N>::reserve(int n) {
 	if(n > v_capacity) {
-		T *newArray = new T[n];  //Allocate memory for newArray array, with size n
-		for(int i = 0; i < v_size; i++) {
-			newArray[i] = array[i];  //Copy elements from array to newArray array
-		}
-		delete[] array;  //Delete the old array
-		array = newArray;  //Assign newArray to array
-		v_capacity = n;  //Update capacity of vector
+		reallocate(n);  //Move the elements to a larger storage
 	}
 }	
 
 // This method returns true if the vector is empty, False otherwise
-template<typename T>
-bool MyVector<T>::empty() const {
+template<typename T, int N>
+bool MyVector<T, N>::empty() const {
 	return v_size == 0;  //Return true if the vector is empty, False otherwise
 }
 
 // This method returns reference of the first element in the vector
-template<typename T>
-const T& MyVector<T>::front() {
+template<typename T, int N>
+T& MyVector<T, N>::front() {
 	if (empty()) {
 		throw VectorEmpty();  //Throw VectorEmpty exception if the vector is empty
 	}
 	return array[0];  //Return reference of the first element in the vector
 }
 
+template<typename T, int N>
+const T& MyVector<T, N>::front() const {
+	if (empty()) {
+		throw VectorEmpty();
+	}
+	return array[0];
+}
+
 // This method returns reference of the Last element in the vector
-template<typename T>
-const T& MyVector<T>::back() {
+template<typename T, int N>
+T& MyVector<T, N>::back() {
 	if (empty()) {
 		throw VectorEmpty();  //Throw VectorEmpty exception if the vector is empty
 	}
 	return array[v_size - 1];  //Return reference of the Last element in the vector
 }
 
-// This method add an element at the end of vector
-template<typename T>
-void MyVector<T>::push_back(T element) {
+template<typename T, int N>
+const T& MyVector<T, N>::back() const {
+	if (empty()) {
+		throw VectorEmpty();
+	}
+	return array[v_size - 1];
+}
+
+// This method returns a pointer to the storage of the elements
+template<typename T, int N>
+T* MyVector<T, N>::data() {
+	return array;
+}
+
+template<typename T, int N>
+const T* MyVector<T, N>::data() const {
+	return array;
+}
+
+// This method add a copy of an element at the end of vector
+template<typename T, int N>
+void MyVector<T, N>::push_back(const T& element) {
+	emplace_back(element);
+}
+
+// This method moves an element at the end of vector
+template<typename T, int N>
+void MyVector<T, N>::push_back(T&& element) {
+	emplace_back(move(element));
+}
+
+// This method constructs an element in place at the end of vector, from the given constructor arguments
+// The element is constructed before the old storage is released, so the arguments may refer to an element of the vector
+template<typename T, int N>
+template<typename... Args>
+T& MyVector<T, N>::emplace_back(Args&&... args) {
 	//Check if the vector is full
 	if (v_size == v_capacity) {
-		reserve(max(1, 2* v_capacity));  //Increase the capacity of the vector by 2 times the current capacity
+		int newCapacity = max(1, 2* v_capacity);  //Increase the capacity of the vector by 2 times the current capacity
+		T *newArray = allocate(newCapacity);
+		new (newArray + v_size) T(forward<Args>(args)...);  //Construct the new element first
+		for (int i = 0; i < v_size; i++) {
+			new (newArray + i) T(move_if_noexcept(array[i]));  //Move elements from array to newArray
+			array[i].~T();
+		}
+		release();
+		array = newArray;
+		v_capacity = newCapacity;
+	} else {
+		new (array + v_size) T(forward<Args>(args)...);  //Construct the element at the end of vector
 	}
-	array[v_size] = element;  //Add an element at the end of vector
 	v_size++;  //Increment the size of vector
+	return array[v_size - 1];
 }
 
 // This method add an element at the index
-template<typename T>
-void MyVector<T>::insert(int index, T element) {
+template<typename T, int N>
+void MyVector<T, N>::insert(int index, T element) {
 	if (index < 0 || index >= v_size) {
 		throw out_of_range("Vector index out of range...!");  //Throw out_of_range exception if the index is out of range
 	}
@@ -148,34 +365,50 @@ void MyVector<T>::insert(int index, T element) {
 	if (v_size == v_capacity) {
 		reserve(max(1, 2* v_capacity));  //Increase the capacity of the vector by 2 times the current capacity
 	}
-	for (int i = v_size-1; i >= index; i--) {
-		array[i+1] = array[i];  //Shift elements to the right
+	new (array + v_size) T(move(array[v_size-1]));  //The last element moves to the new slot
+	for (int i = v_size-2; i >= index; i--) {
+		array[i+1] = move(array[i]);  //Shift elements to the right
 	}
-	array[index] = element;  //Add an element at the index
+	array[index] = move(element);  //Add an element at the index
 	v_size++;  //Increment the size of vector
 }
 
 // This method removes an element at the index from the vector
-template<typename T>
-void MyVector<T>::erase(int index) {
+template<typename T, int N>
+void MyVector<T, N>::erase(int index) {
 	if (index < 0 || index >= v_size) {
 		throw out_of_range("Vector index out of range...!");  //Throw out_of_range exception if the index is out of range
 	}
 	for (int i = index; i < v_size-1; i++) {
-		array[i] = array[i+1];  //Shift elements to the left
+		array[i] = move(array[i+1]);  //Shift elements to the left
 	}
+	array[v_size-1].~T();  //Destroy the last (moved from) element
 	v_size--;  //Decrement the size of vector
 }
 
+// This method removes all the elements from the vector, its storage is kept for reuse
+template<typename T, int N>
+void MyVector<T, N>::clear() {
+	for (int i = 0; i < v_size; i++) {
+		array[i].~T();  //Destroy each element
+	}
+	v_size = 0;
+}
+
 // This method returns the reference of an element at given index
-template<typename T>
-T& MyVector<T>::operator[](int index) {
+template<typename T, int N>
+T& MyVector<T, N>::operator[](int index) {
 	return array[index];  //Return the reference of an element at given index
 }
 
+template<typename T, int N>
+const T& MyVector<T, N>::operator[](int index) const {
+	return array[index];
+}
+
 // This method returns the reference of the element at given index, it throws out_of_range exception if the index is out of range
-template<typename T>
-T& MyVector<T>::at(int index) {
+template<typename T, int N>
+T& MyVector<T, N>::at(int index) {
 	if (index < 0 || index >= v_size) {
 		throw out_of_range("Vector index out of range...!");  //Throw out_of_range exception if the index is out of range
 	}
@@ -183,18 +416,12 @@ T& MyVector<T>::at(int index) {
 }
 
 // This method reduce vector capacity to fit its size
-template<typename T>
-void MyVector<T>::shrink_to_fit() {
+template<typename T, int N>
+void MyVector<T, N>::shrink_to_fit() {
 	//Check if the size of vector is less than the capacity of vector
-	if (v_size < v_capacity) {
-		T *newArray = new T[v_size];  //Allocate memory for newArray array, with size v_size
-		for(int i = 0; i < v_size; i++) {
-			newArray[i] = array[i];  //Copy elements from array to newArray array
-		}
-		delete[] array;  //Delete the old array
-		array = newArray;  //Assign newArray to array
-		v_capacity = v_size;  //Update capacity of vector
+	if (v_size < v_capacity && !isInline()) {
+		reallocate(v_size);  //Move the elements to a storage of exactly v_size slots (the inline one if they fit)
 	}
 }
 		
-#endif
\ No newline at end of file
+#endif
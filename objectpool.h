@@ -0,0 +1,253 @@
+#ifndef OBJECTPOOL_H
+#define OBJECTPOOL_H
+
+//============================================================================
+// Name         : objectpool.h
+// Author       : Bertin Iradukunda
+// Version      : 1.0
+// Date Created : October 16, 2026
+// Date Modified: October 16, 2026
+// Description  : Slab allocator used for the Book and Node objects of the catalog
+//============================================================================
+
+#include <cstddef>
+#include <new>
+#include <mutex>
+#include "myvector.h"
+
+using namespace std;
+
+// Under AddressSanitizer the pools hand every object to the global operator new, so that a use of a
+// freed Book or Node is still reported instead of landing in a recycled slot
+#if defined(__SANITIZE_ADDRESS__)
+#define OBJECTPOOL_BYPASS
+#elif defined(__has_feature)
+#if __has_feature(address_sanitizer)
+#define OBJECTPOOL_BYPASS
+#endif
+#endif
+
+// Number of slots a thread cache takes from the pool, or gives back to it, under one lock
+#define OBJECTPOOL_CACHE_BATCH 64
+
+// Template class for a pool of fixed-size slots, carved out of slabs of SlabSize objects
+// Objects allocated one after the other sit next to each other in memory (better locality when the
+// catalog is traversed), and a freed slot goes on a free list and is handed out again before any new slab is
+// allocated. The objects are still destroyed one by one (their strings must be freed), only the memory of the
+// slots is recycled, and the slabs themselves are only released when the pool is destroyed (i.e. at shutdown)
+// The pool is thread-safe, so the Books of a parallel import can be created on several threads, and a subtree
+// can be freed by the reaper thread. Each thread keeps a small cache of free slots, so that allocate and
+// deallocate only take the lock of the pool once every OBJECTPOOL_CACHE_BATCH calls
+template <typename T, int SlabSize = 1024>
+class ObjectPool
+{
+	private:
+	    // A slot holds either an object or, once freed, the link to the next free slot
+	    union Slot
+	    {
+	        Slot* next;
+	        alignas(T) unsigned char storage[sizeof(T)];
+	    };
+
+	    // Free slots kept by one thread, for the first pool of type T the thread used (other pools of the same
+	    // type take the lock every time). They go back to the pool when the thread ends
+	    struct ThreadCache
+	    {
+	        ObjectPool* owner;                               // Pool the slots belong to
+	        Slot* slots[2 * OBJECTPOOL_CACHE_BATCH];         // Free slots, the last one freed first
+	        int count;                                       // Number of slots in the cache
+	        bool closed;                                     // True once the thread's cache was destroyed
+
+	        ThreadCache() : owner(nullptr), count(0), closed(false) {}
+	        ~ThreadCache();
+	    };
+	    static thread_local ThreadCache cache;
+
+	    MyVector<Slot*> slabs;   // Allocated slabs, each one is an array of SlabSize slots
+	    Slot* freeList;          // Freed slots, the last one freed first
+	    int used;                // Number of slots handed out from the last slab
+	    mutex lock;              // Serializes the accesses to the slabs and the free list
+
+	    // Helper methods, called with the lock held, to take a free slot and to put one back on the free list
+	    Slot* takeSlot();
+	    void putSlot(Slot* slot);
+
+	    // Helper method to get the cache of the calling thread if it holds the slots of this pool, nullptr otherwise
+	    ThreadCache* localCache();
+
+	public:
+	    // Constructor to initialize an empty pool (the first slab is allocated on demand)
+	    ObjectPool() : freeList(nullptr), used(SlabSize) {}
+
+	    // Destructor, it releases all the slabs (the objects must have been destroyed)
+	    ~ObjectPool();
+
+	    // Method to get the memory of one object (sizeof(T) bytes, an operator new using it must fall back to
+	    // the global one for any other size)
+	    void* allocate();
+
+	    // Method to get the memory of count objects with a single lock (e.g. a batch of objects created by one
+	    // worker thread), they are constructed with a placement new and freed one by one with deallocate
+	    void allocate(void** pointers, int count);
+
+	    // Method to give back the memory of an object allocated by this pool
+	    void deallocate(void* pointer);
+
+	    // Method to get the number of bytes reserved by the slabs
+	    size_t reservedBytes();
+};
+
+template <typename T, int SlabSize>
+thread_local typename ObjectPool<T, SlabSize>::ThreadCache ObjectPool<T, SlabSize>::cache;
+
+// This destructor gives the slots of an ending thread back to their pool
+// (closed keeps a later call on the same thread, e.g. from the destructor of a static object, away from the cache)
+template <typename T, int SlabSize>
+ObjectPool<T, SlabSize>::ThreadCache::~ThreadCache()
+{
+	if (owner != nullptr && count > 0)
+	{
+		lock_guard<mutex> guard(owner->lock);
+		while (count > 0)
+		{
+			owner->putSlot(slots[--count]);
+		}
+	}
+	closed = true;
+}
+
+// This destructor releases every slab in one pass
+template <typename T, int SlabSize>
+ObjectPool<T, SlabSize>::~ObjectPool()
+{
+	for (int i = 0; i < slabs.size(); i++)
+	{
+		delete[] slabs[i];
+	}
+}
+
+// This method returns a recycled slot if there is one, otherwise the next slot of the last slab
+template <typename T, int SlabSize>
+typename ObjectPool<T, SlabSize>::Slot* ObjectPool<T, SlabSize>::takeSlot()
+{
+	if (freeList != nullptr)
+	{
+		Slot* slot = freeList;
+		freeList = slot->next;
+		return slot;
+	}
+	if (used == SlabSize)
+	{
+		slabs.push_back(new Slot[SlabSize]);
+		used = 0;
+	}
+	return &slabs[slabs.size() - 1][used++];
+}
+
+// This method puts a slot on the free list
+template <typename T, int SlabSize>
+void ObjectPool<T, SlabSize>::putSlot(Slot* slot)
+{
+	slot->next = freeList;
+	freeList = slot;
+}
+
+// This method returns the cache of the calling thread, the first pool of type T a thread uses owns its cache
+template <typename T, int SlabSize>
+typename ObjectPool<T, SlabSize>::ThreadCache* ObjectPool<T, SlabSize>::localCache()
+{
+	ThreadCache& local = cache;
+	if (local.closed)
+	{
+		return nullptr;
+	}
+	if (local.owner == nullptr)
+	{
+		local.owner = this;
+	}
+	return local.owner == this ? &local : nullptr;
+}
+
+// This method hands out a slot of the thread cache, which is refilled from the pool when it is empty
+template <typename T, int SlabSize>
+void* ObjectPool<T, SlabSize>::allocate()
+{
+#ifdef OBJECTPOOL_BYPASS
+	return ::operator new(sizeof(T));
+#else
+	ThreadCache* local = localCache();
+	if (local == nullptr)
+	{
+		lock_guard<mutex> guard(lock);
+		return takeSlot()->storage;
+	}
+	if (local->count == 0)
+	{
+		lock_guard<mutex> guard(lock);
+		while (local->count < OBJECTPOOL_CACHE_BATCH)
+		{
+			local->slots[local->count++] = takeSlot();
+		}
+	}
+	return local->slots[--local->count]->storage;
+#endif
+}
+
+// This method hands out count slots under one lock: the recycled slots first, then the next slots of the slabs
+template <typename T, int SlabSize>
+void ObjectPool<T, SlabSize>::allocate(void** pointers, int count)
+{
+#ifdef OBJECTPOOL_BYPASS
+	for (int i = 0; i < count; i++)
+	{
+		pointers[i] = ::operator new(sizeof(T));
+	}
+#else
+	lock_guard<mutex> guard(lock);
+	for (int i = 0; i < count; i++)
+	{
+		pointers[i] = takeSlot()->storage;
+	}
+#endif
+}
+
+// This method puts the slot of an object in the thread cache, half of a full cache goes back to the pool
+template <typename T, int SlabSize>
+void ObjectPool<T, SlabSize>::deallocate(void* pointer)
+{
+	if (pointer == nullptr)
+	{
+		return;
+	}
+#ifdef OBJECTPOOL_BYPASS
+	::operator delete(pointer);
+#else
+	Slot* slot = static_cast<Slot*>(pointer);
+	ThreadCache* local = localCache();
+	if (local == nullptr)
+	{
+		lock_guard<mutex> guard(lock);
+		putSlot(slot);
+		return;
+	}
+	if (local->count == 2 * OBJECTPOOL_CACHE_BATCH)
+	{
+		lock_guard<mutex> guard(lock);
+		while (local->count > OBJECTPOOL_CACHE_BATCH)
+		{
+			putSlot(local->slots[--local->count]);
+		}
+	}
+	local->slots[local->count++] = slot;
+#endif
+}
+
+// This method returns the number of bytes reserved by the slabs of the pool
+template <typename T, int SlabSize>
+size_t ObjectPool<T, SlabSize>::reservedBytes()
+{
+	lock_guard<mutex> guard(lock);
+	return (size_t)slabs.size() * SlabSize * sizeof(Slot);
+}
+
+#endif
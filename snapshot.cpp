@@ -0,0 +1,282 @@
+// Name         : snapshot.cpp
+// Author       : Bertin Iradukunda
+// Version      : 1.0
+// Date Created : October 16, 2026
+// Date Modified: October 16, 2026
+// Description  : Checksum and validation of the binary catalog snapshots
+//============================================================================
+
+#include "snapshot.h"
+#include "fuzzy.h"
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <algorithm>
+#include <unordered_set>
+using namespace std;
+
+// This method computes the checksum of a buffer: FNV-1a style mixing of 8-byte words, then of the last bytes
+uint64_t snapshotChecksum(const char* data, size_t length) {
+    uint64_t hash = 14695981039346656037ULL;
+    size_t i = 0;
+    for (; i + 8 <= length; i += 8) {
+        uint64_t word;
+        memcpy(&word, data + i, 8);
+        hash = (hash ^ word) * 1099511628211ULL;
+        hash ^= hash >> 29; // Spread the high bits of the product back to the low ones
+    }
+    for (; i < length; i++) {
+        hash = (hash ^ (unsigned char)data[i]) * 1099511628211ULL;
+    }
+    return hash;
+}
+
+// This helper method checks that a string lies inside the string table
+static bool validString(const SnapshotString& str, uint64_t stringBytes) {
+    return (uint64_t)str.offset + str.length <= stringBytes;
+}
+
+// This method checks that a buffer holds a complete and consistent snapshot
+// Besides the bounds of every index and string, it checks the layout the readers rely on: the categories are in
+// pre-order (the subtree of a category is [i, subtreeEnd), nested in the subtree of its parent), and their books
+// are grouped in the same order (each category's books follow those of the previous one, every book points back to
+// its category). The normalized name of each category must match its name and be unique among its siblings, as in
+// the Tree. Once it returns nullptr, the indices and strings of the snapshot can be followed without further checks
+const char* validateSnapshot(const char* data, size_t length) {
+    if (length < sizeof(SnapshotHeader)) {
+        return "file too small to be a snapshot";
+    }
+    SnapshotHeader header;
+    memcpy(&header, data, sizeof(header));
+    if (memcmp(header.magic, SNAPSHOT_MAGIC, 8) != 0) {
+        return "not a snapshot file";
+    }
+    if (header.version != SNAPSHOT_VERSION) {
+        return "unsupported snapshot version";
+    }
+    uint64_t expected = sizeof(SnapshotHeader) + (uint64_t)header.nodeCount * sizeof(SnapshotNode) +
+                        (uint64_t)header.bookCount * sizeof(SnapshotBook) + header.stringBytes;
+    if (header.totalSize != length || expected != length) {
+        return "truncated snapshot";
+    }
+    if (snapshotChecksum(data + sizeof(SnapshotHeader), length - sizeof(SnapshotHeader)) != header.checksum) {
+        return "checksum mismatch (corrupted snapshot)";
+    }
+
+    const SnapshotNode* nodes = (const SnapshotNode*)(data + sizeof(SnapshotHeader));
+    const SnapshotBook* books = (const SnapshotBook*)(nodes + header.nodeCount);
+    const char* strings = (const char*)(books + header.bookCount);
+    if (header.nodeCount == 0 || nodes[0].parent != SNAPSHOT_NONE || nodes[0].subtreeEnd != header.nodeCount) {
+        return "snapshot without a root category";
+    }
+    MyVector<uint32_t> ancestors; // Categories whose subtree contains the current one, the innermost last
+    uint64_t nextBook = 0;        // Index the books of the current category must start at
+    unordered_set<string> siblings; // Normalized names of the categories seen so far, by parent
+    for (uint32_t i = 0; i < header.nodeCount; i++) {
+        const SnapshotNode& node = nodes[i];
+        while (!ancestors.empty() && nodes[ancestors.back()].subtreeEnd <= i) {
+            ancestors.erase(ancestors.size() - 1); // The subtrees ending before i are closed
+        }
+        if ((i > 0 && (ancestors.empty() || node.parent != ancestors.back() ||
+                       node.subtreeEnd > nodes[node.parent].subtreeEnd)) ||
+            node.subtreeEnd <= i || node.subtreeEnd > header.nodeCount ||
+            node.firstBook != nextBook || (uint64_t)node.firstBook + node.bookCount > header.bookCount ||
+            !validString(node.name, header.stringBytes) || !validString(node.nameKey, header.stringBytes)) {
+            return "inconsistent category in snapshot";
+        }
+        if (i > 0) {
+            string name(strings + node.name.offset, node.name.length);
+            string nameKey(strings + node.nameKey.offset, node.nameKey.length);
+            if (nameKey != normalize_key(name)) {
+                return "inconsistent category in snapshot";
+            }
+            // Siblings are told apart by the index of their parent followed by their normalized name
+            if (!siblings.insert(to_string(node.parent) + '\x1f' + nameKey).second) {
+                return "duplicate category in snapshot";
+            }
+        }
+        ancestors.push_back(i);
+        nextBook += node.bookCount;
+    }
+    if (nextBook != header.bookCount) {
+        return "inconsistent category in snapshot";
+    }
+    for (uint32_t i = 0; i < header.nodeCount; i++) {
+        // The books of a subtree run up to those of the category following it
+        uint32_t end = (nodes[i].subtreeEnd < header.nodeCount) ? nodes[nodes[i].subtreeEnd].firstBook : header.bookCount;
+        if (nodes[i].totalBooks != end - nodes[i].firstBook) {
+            return "inconsistent category in snapshot";
+        }
+    }
+    for (uint32_t i = 0; i < header.bookCount; i++) {
+        const SnapshotBook& book = books[i];
+        if (book.node >= header.nodeCount || i < nodes[book.node].firstBook ||
+            i >= nodes[book.node].firstBook + nodes[book.node].bookCount ||
+            !validString(book.title, header.stringBytes) || !validString(book.author, header.stringBytes) ||
+            !validString(book.isbn, header.stringBytes) || !validString(book.titleKey, header.stringBytes) ||
+            !validString(book.authorKey, header.stringBytes)) {
+            return "inconsistent book in snapshot";
+        }
+    }
+    return nullptr;
+}
+// Constructor to initialize a view of no snapshot
+SnapshotView::SnapshotView() : nodes(nullptr), books(nullptr), strings(nullptr) {
+    memset(&header, 0, sizeof(header));
+}
+
+// This method maps a snapshot and validates it, the view then refers to the mapping
+bool SnapshotView::open(const string& path, string& error) {
+    if (!file.open(path)) {
+        error = "could not open " + path;
+        return false;
+    }
+    const char* reason = validateSnapshot(file.begin(), file.size());
+    if (reason != nullptr) {
+        error = reason;
+        file.close();
+        return false;
+    }
+    memcpy(&header, file.begin(), sizeof(header));
+    nodes = (const SnapshotNode*)(file.begin() + sizeof(SnapshotHeader));
+    books = (const SnapshotBook*)(nodes + header.nodeCount);
+    strings = (const char*)(books + header.bookCount);
+    return true;
+}
+
+// This method checks if a string of the table is equal to a key
+bool SnapshotView::equals(const SnapshotString& str, const string& key) const {
+    return str.length == key.length() && memcmp(text(str), key.data(), str.length) == 0;
+}
+
+// This method checks if a string of the table contains a key
+bool SnapshotView::contains(const SnapshotString& str, const string& key) const {
+    const char* begin = text(str);
+    const char* end = begin + str.length;
+    return search(begin, end, key.begin(), key.end()) != end || key.empty();
+}
+
+// This method returns the edit distance between a string of the table and a key, bounded by maxDistance
+int SnapshotView::distance(const SnapshotString& str, const string& key, int maxDistance) const {
+    return levenshtein_distance_bounded(text(str), str.length, key.data(), key.length(), maxDistance);
+}
+
+// This method prints a string of the table
+void SnapshotView::write(const SnapshotString& str) const {
+    cout.write(text(str), str.length);
+}
+
+// This method prints the category tree, in the same format as Tree::print
+void SnapshotView::print() const {
+    print_helper("", "", 0);
+}
+
+// This method is the recursive part of print
+// The children of a category follow it, each one starting where the subtree of the previous one ends
+void SnapshotView::print_helper(const string& padding, const char* pointer, uint32_t node) const {
+    cout << padding << pointer;
+    write(nodes[node].name);
+    cout << "(" << nodes[node].totalBooks << ")" << endl;
+
+    string childPadding = padding;
+    if (node != 0) {
+        bool last = nodes[node].subtreeEnd == nodes[nodes[node].parent].subtreeEnd;
+        childPadding += last ? "   " : "│  ";
+    }
+    for (uint32_t child = node + 1; child < nodes[node].subtreeEnd; child = nodes[child].subtreeEnd) {
+        bool last = nodes[child].subtreeEnd == nodes[node].subtreeEnd;
+        print_helper(childPadding, last ? "└──" : "├──", child);
+    }
+}
+
+// This method returns the index of the category at the given path, or SNAPSHOT_NONE
+uint32_t SnapshotView::getNode(const string& path) const {
+    uint32_t node = 0; // Start from the root
+    string category;
+    stringstream sstr(path);
+    while (getline(sstr, category, '/')) {
+        if (category == "") continue; // Skip empty categories
+        string key = normalize_key(category);
+        uint32_t child = node + 1;
+        while (child < nodes[node].subtreeEnd && !equals(nodes[child].nameKey, key)) {
+            child = nodes[child].subtreeEnd;
+        }
+        if (child >= nodes[node].subtreeEnd) {
+            return SNAPSHOT_NONE; // The category is not found
+        }
+        node = child;
+    }
+    return node;
+}
+
+// This method prints the books of a category and its subcategories
+// They are contiguous in the snapshot: from the first book of the category to the first book following its subtree
+uint32_t SnapshotView::printAll(uint32_t node) const {
+    uint32_t first = nodes[node].firstBook;
+    uint32_t end = (nodes[node].subtreeEnd < header.nodeCount) ? nodes[nodes[node].subtreeEnd].firstBook : header.bookCount;
+    for (uint32_t book = first; book < end; book++) {
+        printBook(book);
+    }
+    return end - first;
+}
+
+// This method finds a book by its normalized title
+// An exact title wins, otherwise the closest title within maxDistance (first in pre-order on a tie, as in the Tree)
+uint32_t SnapshotView::findBook(const string& titleKey, int maxDistance) const {
+    for (uint32_t book = 0; book < header.bookCount; book++) {
+        if (equals(books[book].titleKey, titleKey)) {
+            return book;
+        }
+    }
+    uint32_t closest = SNAPSHOT_NONE;
+    int closestDistance = maxDistance + 1;
+    for (uint32_t book = 0; book < header.bookCount; book++) {
+        int d = distance(books[book].titleKey, titleKey, maxDistance);
+        if (d > maxDistance) {
+            continue;
+        }
+        if (d < closestDistance) { // The books are in pre-order, the first one wins a tie
+            closest = book;
+            closestDistance = d;
+        }
+    }
+    return closest;
+}
+
+// This method finds the categories and the books matching a normalized keyword (substring or within maxDistance)
+void SnapshotView::find(const string& keywordKey, int maxDistance, MyVector<uint32_t>& categoriesFound, MyVector<uint32_t>& booksFound) const {
+    for (uint32_t node = 0; node < header.nodeCount; node++) {
+        const SnapshotString& name = nodes[node].nameKey;
+        if (contains(name, keywordKey) || distance(name, keywordKey, maxDistance) <= maxDistance) {
+            categoriesFound.push_back(node);
+        }
+    }
+    for (uint32_t book = 0; book < header.bookCount; book++) {
+        const SnapshotBook& record = books[book];
+        if (contains(record.titleKey, keywordKey) || contains(record.authorKey, keywordKey) ||
+            distance(record.titleKey, keywordKey, maxDistance) <= maxDistance ||
+            distance(record.authorKey, keywordKey, maxDistance) <= maxDistance) {
+            booksFound.push_back(book);
+        }
+    }
+}
+
+// This method prints a book, in the same format as Book::print
+void SnapshotView::printBook(uint32_t book) const {
+    const SnapshotBook& record = books[book];
+    cout << "Title: ";
+    write(record.title);
+    cout << endl << "Author: ";
+    write(record.author);
+    cout << endl << "ISBN: ";
+    write(record.isbn);
+    cout << endl << "Publication Year: " << record.year << endl;
+    cout << "----------------------------------------" << endl;
+}
+
+// This method prints the name of a category
+void SnapshotView::printName(uint32_t node) const {
+    write(nodes[node].name);
+}
+//=============================================================================
+// End of file
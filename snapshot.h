@@ -0,0 +1,134 @@
+#ifndef _SNAPSHOT_H
+#define _SNAPSHOT_H
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include "csvreader.h"
+#include "myvector.h"
+
+using namespace std;
+
+// Binary snapshot of a catalog, written by "save" and read back by "load"
+//
+// Layout (native byte order, every section 4-byte aligned):
+//   SnapshotHeader
+//   SnapshotNode[nodeCount]    categories in pre-order, the root first
+//   SnapshotBook[bookCount]    books in pre-order of their categories, so that a subtree's books are contiguous
+//   string table               stringBytes bytes, the strings referred to by offset and length (not terminated)
+//
+// The checksum covers everything after the header, so a truncated or corrupted file is rejected
+
+#define SNAPSHOT_MAGIC "LCMSSNAP"
+#define SNAPSHOT_VERSION 1
+#define SNAPSHOT_NONE 0xFFFFFFFFu   // Parent index of the root
+
+// A string of the string table
+struct SnapshotString
+{
+	    uint32_t offset;    // Position of the first byte in the string table
+	    uint32_t length;    // Number of bytes
+};
+
+// Header of a snapshot file
+struct SnapshotHeader
+{
+	    char magic[8];          // SNAPSHOT_MAGIC, without the terminating zero
+	    uint32_t version;       // SNAPSHOT_VERSION
+	    uint32_t nodeCount;     // Number of categories, the root included
+	    uint32_t bookCount;     // Number of books
+	    uint32_t reserved;      // Always 0
+	    uint64_t stringBytes;   // Size of the string table
+	    uint64_t totalSize;     // Size of the whole file
+	    uint64_t checksum;      // snapshotChecksum of everything after the header
+};
+
+// A category of the catalog
+struct SnapshotNode
+{
+	    SnapshotString name;        // Name of the category
+	    SnapshotString nameKey;     // Normalized name (lowercase, stripped)
+	    uint32_t parent;            // Index of the parent category (SNAPSHOT_NONE for the root)
+	    uint32_t subtreeEnd;        // Index following the last category of the subtree
+	    uint32_t firstBook;         // Index of the first book of the category
+	    uint32_t bookCount;         // Number of books of the category itself
+	    uint32_t totalBooks;        // Number of books of the subtree
+};
+
+// A book of the catalog
+struct SnapshotBook
+{
+	    SnapshotString title;       // Title as entered
+	    SnapshotString author;      // Author as entered
+	    SnapshotString isbn;        // ISBN as entered
+	    SnapshotString titleKey;    // Normalized title
+	    SnapshotString authorKey;   // Normalized author
+	    int32_t year;               // Publication year
+	    uint32_t node;              // Index of the category holding the book
+};
+
+// This method computes the checksum stored in a snapshot header (64-bit, 8 bytes at a time)
+uint64_t snapshotChecksum(const char* data, size_t length);
+
+// This method checks that a buffer holds a complete and consistent snapshot (header, sizes, checksum, indices)
+// It returns nullptr if it does, or the reason why it does not
+const char* validateSnapshot(const char* data, size_t length);
+
+// Class representing a read-only catalog served straight from a mapped snapshot
+// No Book or Node is created: the strings are used in place (pointer and length into the mapping), so several
+// processes opening the same snapshot share a single page-cache copy of it
+class SnapshotView
+{
+	private:
+	    MappedFile file;                // The mapped snapshot
+	    SnapshotHeader header;          // Copy of its header
+	    const SnapshotNode* nodes;      // Categories, in pre-order
+	    const SnapshotBook* books;      // Books, in pre-order of their categories
+	    const char* strings;            // String table
+
+	    // Helper methods to get the characters of a string of the table, and to compare it with a key
+	    const char* text(const SnapshotString& str) const { return strings + str.offset; }
+	    bool equals(const SnapshotString& str, const string& key) const;
+	    bool contains(const SnapshotString& str, const string& key) const;
+	    int distance(const SnapshotString& str, const string& key, int maxDistance) const;
+
+	    // Helper methods to print a string of the table, and the tree below a category
+	    void write(const SnapshotString& str) const;
+	    void print_helper(const string& padding, const char* pointer, uint32_t node) const;
+
+	    // The mapping cannot be shared between two objects
+	    SnapshotView(const SnapshotView&);
+	    SnapshotView& operator=(const SnapshotView&);
+
+	public:
+	    // Constructor to initialize a view of no snapshot
+	    SnapshotView();
+
+	    // Method to map and validate a snapshot, returns false (and the reason in error) if it cannot be used
+	    bool open(const string& path, string& error);
+
+	    // Methods to get the number of books and categories of the snapshot
+	    uint32_t bookCount() const { return header.bookCount; }
+	    uint32_t nodeCount() const { return header.nodeCount; }
+
+	    // Method to print the category tree, like Tree::print
+	    void print() const;
+
+	    // Method to get the index of the category at the given path (like Tree::getNode), SNAPSHOT_NONE if there is none
+	    uint32_t getNode(const string& path) const;
+
+	    // Method to print the books of a category and its subcategories (like Tree::printAll), returns their number
+	    uint32_t printAll(uint32_t node) const;
+
+	    // Method to find a book by its title (exact match first, then the closest fuzzy match), SNAPSHOT_NONE if there is none
+	    uint32_t findBook(const string& titleKey, int maxDistance) const;
+
+	    // Method to find the categories and the books whose name, title or author contains (or nearly matches) a keyword
+	    void find(const string& keywordKey, int maxDistance, MyVector<uint32_t>& categoriesFound, MyVector<uint32_t>& booksFound) const;
+
+	    // Methods to print a book (like Book::print) and the name of a category
+	    void printBook(uint32_t book) const;
+	    void printName(uint32_t node) const;
+};
+
+#endif
@@ -0,0 +1,106 @@
+//============================================================================
+// Name         : stringpool.cpp
+// Author       : Bertin Iradukunda
+// Version      : 1.0
+// Date Created : October 16, 2026
+// Date Modified: October 16, 2026
+// Description  : Interning pool sharing the identical author and category strings of the catalog
+//============================================================================
+
+#include "stringpool.h"
+using namespace std;
+
+// Longest string kept inside a std::string object, without a heap buffer (libstdc++)
+#define STRING_INLINE_CAPACITY 15
+
+// Constructor to initialize an empty pool
+StringPool::StringPool() : references(0), copyBytes(0), distinctBytes(0) {}
+
+// This method returns the bytes taken by a std::string holding str: the object, plus its heap buffer for a long string
+size_t StringPool::footprint(const string& str) {
+    return sizeof(string) + (str.length() > STRING_INLINE_CAPACITY ? str.length() + 1 : 0);
+}
+
+// This method returns the single copy of a string, it is added to the pool on its first reference
+// The keys of an unordered_map never move, so their address can be handed out
+// Several references can be taken at once, e.g. for all the books of an author loaded from a snapshot
+const string* StringPool::intern(const string& str, size_t count) {
+    lock_guard<mutex> guard(lock);
+    unordered_map<string, size_t>::iterator it = entries.insert(make_pair(str, (size_t)0)).first;
+    if (it->second == 0) {
+        distinctBytes += footprint(str); // First reference
+    }
+    it->second += count;
+    references += count;
+    copyBytes += count * footprint(str);
+    return &it->first;
+}
+
+// This method interns a batch of strings under one lock (e.g. the authors of the books created by one worker thread)
+void StringPool::internAll(const string* const* strs, size_t count, const string** interned) {
+    lock_guard<mutex> guard(lock);
+    for (size_t i = 0; i < count; i++) {
+        unordered_map<string, size_t>::iterator it = entries.find(*strs[i]); // Most authors are already in the pool
+        if (it == entries.end()) {
+            it = entries.insert(make_pair(*strs[i], (size_t)0)).first;
+        }
+        if (it->second++ == 0) {
+            distinctBytes += footprint(it->first); // First reference
+        }
+        references++;
+        copyBytes += footprint(it->first);
+        interned[i] = &it->first;
+    }
+}
+
+// This method drops a reference, the string leaves the pool with its last reference
+void StringPool::release(const string* str) {
+    if (str == nullptr) {
+        return;
+    }
+    lock_guard<mutex> guard(lock);
+    unordered_map<string, size_t>::iterator it = entries.find(*str);
+    if (it == entries.end()) {
+        return; // Not from this pool
+    }
+    references--;
+    copyBytes -= footprint(it->first);
+    if (--it->second == 0) {
+        distinctBytes -= footprint(it->first);
+        entries.erase(it);
+    }
+}
+
+// This method looks a string up without referencing it
+const string* StringPool::find(const string& str) {
+    lock_guard<mutex> guard(lock);
+    unordered_map<string, size_t>::const_iterator it = entries.find(str);
+    return (it == entries.end()) ? nullptr : &it->first;
+}
+
+// This method returns the number of live references
+size_t StringPool::referenceCount() {
+    lock_guard<mutex> guard(lock);
+    return references;
+}
+
+// This method returns the number of distinct strings in the pool
+size_t StringPool::distinctCount() {
+    lock_guard<mutex> guard(lock);
+    return entries.size();
+}
+
+// This method returns the bytes taken by the pool: each distinct string once, and a pointer per reference
+size_t StringPool::storedBytes() {
+    lock_guard<mutex> guard(lock);
+    return distinctBytes + references * sizeof(const string*);
+}
+
+// This method returns the bytes saved by the pool, compared to a separate copy of the string per reference
+size_t StringPool::savedBytes() {
+    lock_guard<mutex> guard(lock);
+    size_t stored = distinctBytes + references * sizeof(const string*);
+    return (copyBytes > stored) ? copyBytes - stored : 0;
+}
+//=============================================================================
+// End of file
@@ -0,0 +1,53 @@
+#ifndef _STRINGPOOL_H
+#define _STRINGPOOL_H
+
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+#include <mutex>
+
+using namespace std;
+
+// Pool of interned strings: identical strings are stored once and shared
+// intern returns the address of the single copy, so two interned strings are equal if and only if their
+// addresses are, and comparing them costs a pointer comparison. The copies are reference counted and
+// dropped by the last release. The pool is thread-safe (books are created and freed on several threads)
+class StringPool
+{
+	private:
+	    unordered_map<string, size_t> entries;  // Distinct strings, with their number of references
+	    size_t references;      // Number of live references
+	    size_t copyBytes;       // Bytes the referenced strings would take as separate copies
+	    size_t distinctBytes;   // Bytes taken by the distinct strings
+	    mutex lock;             // Serializes the accesses to the pool
+
+	    // Helper method to get the bytes taken by a std::string holding str
+	    static size_t footprint(const string& str);
+
+	public:
+	    // Constructor to initialize an empty pool
+	    StringPool();
+
+	    // Method to get the interned copy of a string, adding count references to it (each one is dropped by a release)
+	    const string* intern(const string& str, size_t count = 1);
+
+	    // Method to intern count strings with a single lock, interned[i] receives the copy of *strs[i] (one reference each)
+	    void internAll(const string* const* strs, size_t count, const string** interned);
+
+	    // Method to drop a reference obtained from intern
+	    void release(const string* str);
+
+	    // Method to get the interned copy of a string without adding a reference, nullptr if it is not in the pool
+	    const string* find(const string& str);
+
+	    // Methods to get the number of live references and of distinct strings
+	    size_t referenceCount();
+	    size_t distinctCount();
+
+	    // Methods to get the bytes taken by the pool (the distinct strings and a pointer per reference),
+	    // and the bytes saved compared to storing a separate copy per reference
+	    size_t storedBytes();
+	    size_t savedBytes();
+};
+
+#endif
@@ -0,0 +1,205 @@
+// Name         : symspell.cpp
+// Author       : Bertin Iradukunda
+// Version      : 1.0
+// Date Created : October 16, 2026
+// Date Modified: October 16, 2026
+// Description  : SymSpell-style deletion dictionary used for "did you mean" title corrections
+//============================================================================
+
+#include "symspell.h"
+#include "fuzzy.h"
+using namespace std;
+
+// This helper method returns the 64-bit FNV-1a hash of a string
+static uint64_t hashVariant(const string& str) {
+    uint64_t hash = 14695981039346656037ULL;
+    for (size_t i = 0; i < str.length(); i++) {
+        hash ^= (unsigned char)str[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+// Constructor to initialize an empty dictionary
+SuggestionDictionary::SuggestionDictionary(int maxDistance, int prefixLength)
+    : maxDistance(maxDistance), prefixLength(prefixLength), variantCount(0), keyBytes(0) {}
+
+// This method generates the hashes of all the strings obtained by deleting up to maxDistance characters
+// from the prefix of str (the prefix itself included)
+void SuggestionDictionary::generateDeletes(const string& str, MyVector<uint64_t>& variants) {
+    unordered_set<string> seen;
+    string prefix = str.substr(0, prefixLength);
+    seen.insert(prefix);
+    generateDeletes_helper(prefix, 0, seen);
+    for (const string& variant : seen) {
+        variants.push_back(hashVariant(variant));
+    }
+}
+
+// This method is the recursive part of generateDeletes, it deletes one more character from str
+void SuggestionDictionary::generateDeletes_helper(const string& str, int distance, unordered_set<string>& seen) {
+    if (distance == maxDistance) {
+        return;
+    }
+    for (size_t pos = 0; pos < str.length(); pos++) {
+        string variant = str;
+        variant.erase(pos, 1);
+        if (seen.insert(variant).second) {
+            generateDeletes_helper(variant, distance + 1, seen);
+        }
+    }
+}
+
+// This method adds a key to the dictionary
+// Adding a key that is already known only counts it once more (its variants are stored once)
+void SuggestionDictionary::add(const string& key) {
+    unordered_map<string, int>::iterator found = keyIds.find(key);
+    if (found != keyIds.end()) {
+        keyCounts[found->second]++;
+        return;
+    }
+    int id = keys.size();
+    keys.push_back(key);
+    keyCounts.push_back(1);
+    keyIds[key] = id;
+    keyBytes += sizeof(string) + key.capacity();
+
+    MyVector<uint64_t> variants;
+    generateDeletes(key, variants);
+    for (int i = 0; i < variants.size(); i++) {
+        deletes[variants[i]].push_back(id);
+        variantCount++;
+    }
+}
+
+// This method removes a key from the dictionary once, the key and its variants are dropped with its last count
+// The last key takes the id of the removed one, so the ids stay dense
+void SuggestionDictionary::remove(const string& key) {
+    unordered_map<string, int>::iterator found = keyIds.find(key);
+    if (found == keyIds.end()) {
+        return;
+    }
+    int id = found->second;
+    if (--keyCounts[id] > 0) {
+        return; // Still added by someone else
+    }
+    int last = keys.size() - 1;
+    keyIds.erase(found);
+    keyBytes -= sizeof(string) + keys[id].capacity();
+
+    MyVector<uint64_t> variants;
+    generateDeletes(keys[id], variants);
+    for (int i = 0; i < variants.size(); i++) {
+        unordered_map<uint64_t, MyVector<int> >::iterator it = deletes.find(variants[i]);
+        MyVector<int>& list = it->second;
+        for (int j = 0; j < list.size(); j++) {
+            if (list[j] == id) {
+                list[j] = list[list.size() - 1]; // The order of a list does not matter, lookup ranks the keys
+                list.erase(list.size() - 1);
+                break;
+            }
+        }
+        if (list.empty()) {
+            deletes.erase(it);
+        }
+        variantCount--;
+    }
+
+    if (id != last) {
+        // Renumber the last key in its lists
+        MyVector<uint64_t> lastVariants;
+        generateDeletes(keys[last], lastVariants);
+        for (int i = 0; i < lastVariants.size(); i++) {
+            MyVector<int>& list = deletes[lastVariants[i]];
+            for (int j = 0; j < list.size(); j++) {
+                if (list[j] == last) {
+                    list[j] = id;
+                    break;
+                }
+            }
+        }
+        keys[id].swap(keys[last]);
+        keyCounts[id] = keyCounts[last];
+        keyIds[keys[id]] = id;
+    }
+    keys.erase(last);
+    keyCounts.erase(last);
+}
+
+// This method finds the keys within maxDistance of the query
+// The deletions of the query are looked up in the dictionary and every candidate is verified with the
+// bounded edit distance (hash collisions and prefix-only matches are filtered out there)
+// The suggestions are ranked by distance, then alphabetically
+void SuggestionDictionary::lookup(const string& query, MyVector<Suggestion>& suggestions) {
+    MyVector<uint64_t> variants;
+    generateDeletes(query, variants);
+
+    unordered_set<int> checked; // Keys already verified
+    for (int i = 0; i < variants.size(); i++) {
+        unordered_map<uint64_t, MyVector<int> >::iterator it = deletes.find(variants[i]);
+        if (it == deletes.end()) {
+            continue;
+        }
+        for (int j = 0; j < it->second.size(); j++) {
+            int id = it->second[j];
+            if (!checked.insert(id).second) {
+                continue;
+            }
+            int distance = levenshtein_distance_bounded(query, keys[id], maxDistance);
+            if (distance > maxDistance) {
+                continue;
+            }
+
+            // Insert the suggestion at its rank
+            Suggestion suggestion = {keys[id], distance};
+            suggestions.push_back(suggestion);
+            for (int k = suggestions.size() - 1; k > 0; k--) {
+                Suggestion& prev = suggestions[k - 1];
+                if (prev.distance < distance || (prev.distance == distance && prev.key <= keys[id])) {
+                    break;
+                }
+                Suggestion tmp = suggestions[k];
+                suggestions[k] = prev;
+                suggestions[k - 1] = tmp;
+            }
+        }
+    }
+}
+
+// This method removes every key from the dictionary
+void SuggestionDictionary::clear() {
+    while (!keys.empty()) {
+        keys.erase(keys.size() - 1);
+    }
+    keyCounts.clear();
+    keyIds.clear();
+    deletes.clear();
+    variantCount = 0;
+    keyBytes = 0;
+}
+
+// This method returns the number of keys in the dictionary
+int SuggestionDictionary::size() const {
+    return keys.size();
+}
+
+// This method returns the number of (variant, key) pairs stored in the dictionary
+long SuggestionDictionary::variants() const {
+    return variantCount;
+}
+
+// This method returns an estimate of the memory used by the dictionary, in bytes
+// Hash tables are counted as their bucket arrays plus one node (key, value and next pointer) per entry
+size_t SuggestionDictionary::memoryUsage() const {
+    size_t bytes = keyBytes + keys.capacity() * sizeof(string) + keyCounts.capacity() * sizeof(int);
+    bytes += keyIds.bucket_count() * sizeof(void*);
+    bytes += keyIds.size() * (sizeof(void*) + sizeof(string) + sizeof(int) + sizeof(size_t));
+    bytes += deletes.bucket_count() * sizeof(void*);
+    bytes += deletes.size() * (sizeof(void*) + sizeof(uint64_t) + sizeof(MyVector<int>));
+    for (unordered_map<uint64_t, MyVector<int> >::const_iterator it = deletes.begin(); it != deletes.end(); ++it) {
+        bytes += it->second.capacity() * sizeof(int);
+    }
+    return bytes;
+}
+//=============================================================================
+// End of file
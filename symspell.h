@@ -0,0 +1,61 @@
+#ifndef _SYMSPELL_H
+#define _SYMSPELL_H
+
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <cstdint>
+#include "myvector.h"
+
+using namespace std;
+
+// A corrected key suggested by the dictionary, with its edit distance to the query
+struct Suggestion
+{
+	    string key;      // Normalized key (e.g. a title) known to the dictionary
+	    int distance;    // Levenshtein distance between the query and the key
+};
+
+// Class representing a SymSpell-style deletion dictionary over normalized keys
+// Every key is stored under all the variants of its prefix obtained by deleting up to maxDistance
+// characters, so the candidates of a misspelled query are found with a handful of hash probes
+// (the deletions of the query) instead of a scan of the whole catalog
+class SuggestionDictionary
+{
+	private:
+	    int maxDistance;                                    // Largest edit distance that can be corrected
+	    int prefixLength;                                   // Only this many leading characters generate deletions
+	    MyVector<string> keys;                              // Distinct keys, referred to by their position
+	    MyVector<int> keyCounts;                            // Number of times each key was added (e.g. books sharing a title)
+	    unordered_map<string, int> keyIds;                  // Position of each key in keys
+	    unordered_map<uint64_t, MyVector<int> > deletes;    // Hash of a deletion variant -> ids of the keys producing it
+	    long variantCount;                                  // Number of (variant, key) pairs stored
+	    size_t keyBytes;                                    // Memory used by the strings of the keys
+
+	    // Helper method to generate the deletion variants of a string (hashed)
+	    void generateDeletes(const string& str, MyVector<uint64_t>& variants);
+	    void generateDeletes_helper(const string& str, int distance, unordered_set<string>& seen);
+
+	public:
+	    // Constructor to initialize an empty dictionary
+	    SuggestionDictionary(int maxDistance, int prefixLength = 7);
+
+	    // Method to add a key (a known key is only counted once more)
+	    void add(const string& key);
+
+	    // Method to remove a key once, its variants go with its last count (removing an unknown key has no effect)
+	    void remove(const string& key);
+
+	    // Method to find the keys within maxDistance of the query, ranked by distance (then alphabetically)
+	    void lookup(const string& query, MyVector<Suggestion>& suggestions);
+
+	    // Method to remove every key
+	    void clear();
+
+	    // Methods to get the number of keys, the number of stored variants and an estimate of the memory used
+	    int size() const;
+	    long variants() const;
+	    size_t memoryUsage() const;
+};
+
+#endif
@@ -0,0 +1,111 @@
+// Name         : dictionary_test.cpp
+// Author       : Bertin Iradukunda
+// Version      : 1.0
+// Date Created : October 17, 2026
+// Date Modified: October 17, 2026
+// Description  : Checks that removing keys from the suggestion dictionary leaves it as if the keys left had been
+//                added to a new one (same keys, variants and suggestions), keys added several times included
+//============================================================================
+// Built and run by: make test
+
+#include "../symspell.h"
+#include <iostream>
+#include <string>
+#include <random>
+#include <unordered_set>
+#include <cstdlib>
+using namespace std;
+
+static int failures = 0;
+
+// check <description> <condition>: prints PASS or FAIL depending on the condition
+static void check(const string& description, bool passed) {
+    cout << (passed ? "PASS: " : "FAIL: ") << description << endl;
+    if (!passed) {
+        failures++;
+    }
+}
+
+// This helper method checks that two dictionaries suggest the same keys, at the same distances, for the queries
+static bool sameSuggestions(SuggestionDictionary& dictionary, SuggestionDictionary& expected, const MyVector<string>& queries) {
+    for (int i = 0; i < queries.size(); i++) {
+        MyVector<Suggestion> found, wanted;
+        dictionary.lookup(queries[i], found);
+        expected.lookup(queries[i], wanted);
+        if (found.size() != wanted.size()) {
+            return false;
+        }
+        for (int j = 0; j < found.size(); j++) {
+            if (found[j].key != wanted[j].key || found[j].distance != wanted[j].distance) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// main function
+int main() {
+    mt19937 rng(11);
+    MyVector<string> keys;
+    unordered_set<string> distinct;
+    while (keys.size() < 300) {
+        string key;
+        int length = 3 + rng() % 12;
+        for (int j = 0; j < length; j++) {
+            key += (char)('a' + rng() % 5); // A small alphabet, so that the keys share many variants
+        }
+        if (distinct.insert(key).second) {
+            keys.push_back(key);
+        }
+    }
+
+    // Every key is added twice, then removed once: nothing must change
+    SuggestionDictionary dictionary(2), expected(2);
+    for (int i = 0; i < keys.size(); i++) {
+        dictionary.add(keys[i]);
+        dictionary.add(keys[i]);
+        expected.add(keys[i]);
+    }
+    for (int i = 0; i < keys.size(); i += 2) {
+        dictionary.remove(keys[i]);
+    }
+    check("a key added twice stays after one removal",
+          dictionary.size() == expected.size() && dictionary.variants() == expected.variants() && sameSuggestions(dictionary, expected, keys));
+
+    // Every other key is removed for good
+    for (int i = 0; i < keys.size(); i += 2) {
+        if (i % 4 != 0) {
+            dictionary.remove(keys[i]);
+        }
+        dictionary.remove(keys[i]);
+    }
+    SuggestionDictionary left(2);
+    for (int i = 1; i < keys.size(); i += 2) {
+        left.add(keys[i]);
+    }
+    check("the removed keys and their variants are gone",
+          dictionary.size() == left.size() && dictionary.variants() == left.variants());
+    check("the keys left are suggested as by a dictionary built from them", sameSuggestions(dictionary, left, keys));
+
+    // Removing an unknown key has no effect, the removed keys can be added again
+    dictionary.remove("unknown key");
+    for (int i = 0; i < keys.size(); i += 2) {
+        dictionary.add(keys[i]);
+    }
+    check("removed keys can be added again", dictionary.size() == expected.size() && sameSuggestions(dictionary, expected, keys));
+
+    // Everything is removed
+    for (int i = 0; i < keys.size(); i++) {
+        dictionary.remove(keys[i]);
+        dictionary.remove(keys[i]);
+    }
+    check("a dictionary whose keys were all removed is empty", dictionary.size() == 0 && dictionary.variants() == 0);
+
+    if (failures != 0) {
+        cout << failures << " check(s) failed" << endl;
+        return EXIT_FAILURE;
+    }
+    cout << "All checks passed" << endl;
+    return EXIT_SUCCESS;
+}
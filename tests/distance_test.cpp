@@ -0,0 +1,130 @@
+// Name         : distance_test.cpp
+// Author       : Bertin Iradukunda
+// Version      : 1.0
+// Date Created : October 17, 2026
+// Date Modified: October 17, 2026
+// Description  : Checks the edit distance engines (bit-parallel, banded, bounded dispatch) against a plain
+//                dynamic programming distance, around the 64-character limit of the bit-parallel engine
+//============================================================================
+// Built and run by: make test
+
+#include "../fuzzy.h"
+#include <iostream>
+#include <string>
+#include <random>
+#include <vector>
+#include <algorithm>
+#include <cstdlib>
+using namespace std;
+
+static int failures = 0;
+
+// check <description> <condition>: prints PASS or FAIL depending on the condition
+static void check(const string& description, bool passed) {
+    cout << (passed ? "PASS: " : "FAIL: ") << description << endl;
+    if (!passed) {
+        failures++;
+    }
+}
+
+// This helper method computes the edit distance with the full dynamic programming table, the reference of the checks
+static int plainDistance(const string& s1, const string& s2) {
+    vector<int> previous(s2.length() + 1), current(s2.length() + 1);
+    for (size_t j = 0; j <= s2.length(); j++) {
+        previous[j] = j;
+    }
+    for (size_t i = 1; i <= s1.length(); i++) {
+        current[0] = i;
+        for (size_t j = 1; j <= s2.length(); j++) {
+            int substitution = previous[j - 1] + (s1[i - 1] != s2[j - 1]);
+            current[j] = min(substitution, min(previous[j], current[j - 1]) + 1);
+        }
+        previous.swap(current);
+    }
+    return previous[s2.length()];
+}
+
+// This helper method returns a random string over a small alphabet (so that the distances stay small enough to be bounded)
+static string randomString(size_t length, mt19937& rng) {
+    string str;
+    for (size_t i = 0; i < length; i++) {
+        str += (char)('a' + rng() % 4);
+    }
+    return str;
+}
+
+// This helper method returns a copy of str with a few random edits (insertions, deletions, substitutions)
+static string mutate(string str, int edits, mt19937& rng) {
+    for (int e = 0; e < edits; e++) {
+        size_t pos = str.empty() ? 0 : rng() % (str.length() + 1);
+        switch (rng() % 3) {
+            case 0: str.insert(pos, 1, (char)('a' + rng() % 4)); break;
+            case 1: if (pos < str.length()) str.erase(pos, 1); break;
+            default: if (pos < str.length()) str[pos] = (char)('a' + rng() % 4); break;
+        }
+    }
+    return str;
+}
+
+// This helper method compares every engine with the reference on a pair, it returns the number of disagreements
+static int compareEngines(const string& s1, const string& s2) {
+    int expected = plainDistance(s1, s2);
+    int wrong = 0;
+    wrong += levenshtein_distance(s1, s2) != expected;
+    if (min(s1.length(), s2.length()) <= MYERS_MAX_PATTERN) {
+        wrong += levenshtein_distance_myers(s1, s2) != expected;
+    }
+    for (int k = 0; k <= 4; k++) {
+        int bounded = min(expected, k + 1); // The bounded engines return k + 1 past k
+        wrong += levenshtein_distance_bounded(s1, s2, k) != bounded;
+        wrong += levenshtein_distance_banded(s1, s2, k) != bounded;
+    }
+    return wrong;
+}
+
+// main function
+int main() {
+    mt19937 rng(7);
+
+    // Empty strings
+    check("the distance between two empty strings is 0", compareEngines("", "") == 0 && levenshtein_distance("", "") == 0);
+    check("the distance from an empty string is the length of the other one",
+          compareEngines("", "abc") == 0 && compareEngines(string(65, 'a'), "") == 0 && levenshtein_distance("", string(64, 'b')) == 64);
+
+    // Lengths around the 64-character word of the bit-parallel engine, equal and different lengths, close and random pairs
+    size_t lengths[] = {1, 2, 31, 32, 33, 63, 64, 65, 100};
+    for (size_t length : lengths) {
+        int wrong = 0;
+        for (int round = 0; round < 200; round++) {
+            string s1 = randomString(length, rng);
+            wrong += compareEngines(s1, mutate(s1, round % 6, rng));
+            wrong += compareEngines(mutate(s1, round % 6, rng), s1);
+            wrong += compareEngines(s1, randomString(rng() % (length + 3), rng));
+        }
+        check("the engines agree with the plain distance for " + to_string(length) + " characters", wrong == 0);
+    }
+
+    // The shorter string decides which engine is used: 63/64/65 characters against longer strings
+    int wrong = 0;
+    for (size_t shorter = 63; shorter <= 65; shorter++) {
+        for (int round = 0; round < 100; round++) {
+            string s1 = randomString(shorter, rng);
+            string s2 = mutate(s1, 1 + round % 4, rng) + randomString(rng() % 3, rng);
+            wrong += compareEngines(s1, s2) + compareEngines(s2, s1);
+        }
+    }
+    check("the engines agree with the plain distance when the shorter string has 63 to 65 characters", wrong == 0);
+
+    // Strings differing only by their last character, the bit of the pattern the word ends with
+    check("a change of the 64th character counts once",
+          compareEngines(string(63, 'a') + "b", string(64, 'a')) == 0 && levenshtein_distance(string(63, 'a') + "b", string(64, 'a')) == 1);
+    check("a change of the 65th character counts once",
+          compareEngines(string(64, 'a') + "b", string(65, 'a')) == 0 && levenshtein_distance(string(64, 'a') + "b", string(65, 'a')) == 1);
+
+    if (failures != 0) {
+        cout << failures << " check(s) failed" << endl;
+        return EXIT_FAILURE;
+    }
+    cout << "All checks passed" << endl;
+    return EXIT_SUCCESS;
+}
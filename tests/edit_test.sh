@@ -0,0 +1,71 @@
+#!/bin/sh
+# Name         : edit_test.sh
+# Author       : Bertin Iradukunda
+# Version      : 1.0
+# Date Created : October 16, 2026
+# Date Modified: October 16, 2026
+# Description  : Checks that export and find see the edits made by editBook
+#                (the flattened layout must not go stale)
+#============================================================================
+# Run from the project directory after make, with: make test
+
+LCMS=${LCMS:-./lcms}
+OUT=$(mktemp -d)
+trap 'rm -rf "$OUT"' EXIT
+failures=0
+
+# check <description> <command>: prints PASS or FAIL depending on the exit status of the command
+check() {
+	if sh -c "$2"; then
+		echo "PASS: $1"
+	else
+		echo "FAIL: $1"
+		failures=$((failures + 1))
+	fi
+}
+
+# findAll and find build the layout before the edit, a stale copy of the books would be used after it
+# ("us" is too short for the trigram index: find scans the books of the layout)
+$LCMS > "$OUT/log.txt" 2>&1 <<SCRIPT
+import booklist.csv
+findAll Biology
+find gene --top 3
+editBook The Selfish Gene
+1
+The Generous Gene
+2
+R. Dawkins
+3
+978-0-19-878860-8
+4
+1999
+5
+export $OUT/export.csv
+find us
+find dawkins
+find us --top 3
+findAll Biology/Evolutionary Biology
+exit
+SCRIPT
+
+# The output of the N-th command is written to command<N> (every command starts with the "> " prompt)
+awk -v dir="$OUT" '/^> /{ n++ } { print > (dir "/command" n) }' "$OUT/log.txt"
+
+check "export writes the edited book" \
+	"grep -q '^The Generous Gene,R. Dawkins,978-0-19-878860-8,1999,Biology/Evolutionary Biology' '$OUT/export.csv'"
+check "export does not write the old title" \
+	"! grep -q 'The Selfish Gene' '$OUT/export.csv'"
+check "find scans the new title" \
+	"grep -q 'Title: The Generous Gene' '$OUT/command6'"
+check "find matches the new author" \
+	"grep -q 'Author: R. Dawkins' '$OUT/command7'"
+check "find --top scans the new title" \
+	"grep -q 'Title: The Generous Gene' '$OUT/command8' && ! grep -q 'The Selfish Gene' '$OUT/command8'"
+check "findAll lists the new ISBN and year" \
+	"grep -q 'ISBN: 978-0-19-878860-8' '$OUT/command9' && grep -q 'Publication Year: 1999' '$OUT/command9'"
+
+if [ $failures -ne 0 ]; then
+	echo "$failures check(s) failed"
+	exit 1
+fi
+echo "All checks passed"
@@ -0,0 +1,74 @@
+#!/bin/sh
+# Name         : import_test.sh
+# Author       : Bertin Iradukunda
+# Version      : 1.0
+# Date Created : October 17, 2026
+# Date Modified: October 17, 2026
+# Description  : Checks that an import on several threads prints the same messages and builds the same catalog
+#                as an import on one thread: duplicates (by ISBN and within a category), incomplete lines,
+#                years that are not numbers, quoted fields and CRLF lines, spread over many chunks
+#============================================================================
+# Run from the project directory after make, with: make test
+
+LCMS=${LCMS:-./lcms}
+OUT=$(mktemp -d)
+trap 'rm -rf "$OUT"' EXIT
+failures=0
+
+# check <description> <command>: prints PASS or FAIL depending on the exit status of the command
+check() {
+	if sh -c "$2"; then
+		echo "PASS: $1"
+	else
+		echo "FAIL: $1"
+		failures=$((failures + 1))
+	fi
+}
+
+# 20000 lines, a few MB: the file is split into many chunks, so the merge runs while the next chunks are parsed
+awk 'BEGIN {
+	srand(12);
+	print "Title,Author,ISBN,Publication Year,Category";
+	for (i = 0; i < 20000; i++) {
+		title = "Book " int(rand() * 6000);
+		if (rand() < 0.1) title = "\"" title ", volume 2\"";
+		author = "Author " int(rand() * 200);
+		r = rand();
+		isbn = (r < 0.4) ? sprintf("978%010d", int(rand() * 5000)) : (r < 0.8) ? "X-" int(rand() * 3000) : (r < 0.9) ? "0-306-40615-2" : "";
+		r = rand();
+		year = (r < 0.9) ? 1900 + int(rand() * 120) : (r < 0.95) ? "unknown" : "";
+		category = "Cat" int(rand() * 20) "/Sub" int(rand() * 4);
+		eol = (i % 3 == 0) ? "\r" : "";
+		r = rand();
+		if (r < 0.02) print title "," author eol;
+		else if (r < 0.03) print "";
+		else print title "," author "," isbn "," year "," category eol;
+	}
+}' > "$OUT/books.csv"
+
+# The second import of the same file only finds duplicates
+for threads in 1 4; do
+	$LCMS > "$OUT/log$threads.txt" 2>&1 <<SCRIPT
+import $OUT/books.csv --threads $threads
+import $OUT/books.csv --threads $threads
+export $OUT/export$threads.csv
+exit
+SCRIPT
+	# The timings and the name of the exported file differ from one run to the other
+	sed -e 's/[0-9.]* ms//g' -e 's|[0-9.]* MB/s||' -e 's|export[0-9]*\.csv||' "$OUT/log$threads.txt" > "$OUT/messages$threads.txt"
+done
+
+check "the import reports duplicates" \
+	"grep -q 'already exists in the catalog' '$OUT/messages1.txt'"
+check "the import reports incomplete lines" \
+	"grep -q 'Incomplete book details' '$OUT/messages1.txt'"
+check "4 threads print the same messages, in the same order, as 1 thread" \
+	"cmp -s '$OUT/messages1.txt' '$OUT/messages4.txt'"
+check "4 threads build the same catalog as 1 thread" \
+	"cmp -s '$OUT/export1.csv' '$OUT/export4.csv'"
+
+if [ $failures -ne 0 ]; then
+	echo "$failures check(s) failed"
+	exit 1
+fi
+echo "All checks passed"
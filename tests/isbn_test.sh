@@ -0,0 +1,85 @@
+#!/bin/sh
+# Name         : isbn_test.sh
+# Author       : Bertin Iradukunda
+# Version      : 1.0
+# Date Created : October 17, 2026
+# Date Modified: October 17, 2026
+# Description  : Checks the normalization of the ISBNs: an ISBN-10 and its ISBN-13 are the same key,
+#                hyphens and spaces are ignored, anything else than an ISBN-10/13 is rejected
+#============================================================================
+# Run from the project directory after make, with: make test
+
+LCMS=${LCMS:-./lcms}
+OUT=$(mktemp -d)
+trap 'rm -rf "$OUT"' EXIT
+failures=0
+
+# check <description> <command>: prints PASS or FAIL depending on the exit status of the command
+check() {
+	if sh -c "$2"; then
+		echo "PASS: $1"
+	else
+		echo "FAIL: $1"
+		failures=$((failures + 1))
+	fi
+}
+
+# The last book is the ISBN-13 form of the first one, the import must report it as a duplicate
+cat > "$OUT/books.csv" <<CSV
+Title,Author,ISBN,Publication Year,Category
+The Ten Digit Book,Author One,0-19-286092-5,1990,Tests
+The Check X Book,Author Two,0-8044-2957-X,1991,Tests
+The 979 Book,Author Three,979-10-90636-07-1,1992,Tests
+The Thirteen Digit Book,Author Four,9780198788607,1993,Tests
+The Same Book Again,Author Five,978-0-19-286092-7,1994,Tests
+CSV
+
+$LCMS > "$OUT/log.txt" 2>&1 <<SCRIPT
+import $OUT/books.csv
+findIsbn 9780192860927
+findIsbn 0192860925
+findIsbn 978-0-8044-2957-3
+findIsbn 080442957x
+findIsbn 979 10 90636 07 1
+findIsbn 0-19-878860-4
+findIsbn 9780000000002
+findIsbn 12345
+findIsbn 977-0-19-878860-8
+findIsbn 97801987886080
+findIsbn 08044X2957
+exit
+SCRIPT
+
+# The output of the N-th command is written to command<N> (every command starts with the "> " prompt)
+awk -v dir="$OUT" '/^> /{ n++ } { print > (dir "/command" n) }' "$OUT/log.txt"
+
+check "an ISBN-13 and the ISBN-10 of the same book are duplicates" \
+	"grep -q 'The Same Book Again' '$OUT/command1' && grep -q '4 books imported' '$OUT/command1'"
+check "an ISBN-10 is found by its ISBN-13" \
+	"grep -q 'Title: The Ten Digit Book' '$OUT/command2'"
+check "an ISBN-10 is found without its hyphens" \
+	"grep -q 'Title: The Ten Digit Book' '$OUT/command3'"
+check "an ISBN-10 ending with X is found by its ISBN-13" \
+	"grep -q 'Title: The Check X Book' '$OUT/command4'"
+check "the X check digit is case insensitive" \
+	"grep -q 'Title: The Check X Book' '$OUT/command5'"
+check "an ISBN-13 starting with 979 is found with spaces" \
+	"grep -q 'Title: The 979 Book' '$OUT/command6'"
+check "an ISBN-13 stored without hyphens is found by its ISBN-10" \
+	"grep -q 'Title: The Thirteen Digit Book' '$OUT/command7'"
+check "a valid ISBN of no book is not found" \
+	"grep -q 'not found' '$OUT/command8'"
+check "too few digits are rejected" \
+	"grep -q 'not a valid ISBN' '$OUT/command9'"
+check "an ISBN-13 not starting with 978 or 979 is rejected" \
+	"grep -q 'not a valid ISBN' '$OUT/command10'"
+check "too many digits are rejected" \
+	"grep -q 'not a valid ISBN' '$OUT/command11'"
+check "an X before the check digit is rejected" \
+	"grep -q 'not a valid ISBN' '$OUT/command12'"
+
+if [ $failures -ne 0 ]; then
+	echo "$failures check(s) failed"
+	exit 1
+fi
+echo "All checks passed"
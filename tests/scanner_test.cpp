@@ -0,0 +1,147 @@
+// Name         : scanner_test.cpp
+// Author       : Bertin Iradukunda
+// Version      : 1.0
+// Date Created : October 17, 2026
+// Date Modified: October 17, 2026
+// Description  : Checks the SIMD structural scanners against the scalar one, and the lines of CSVScanner
+//                against splitCSVLine, on quotes crossing the 32/64-byte blocks and on CRLF line breaks
+//============================================================================
+// Built and run by: make test
+
+#include "../csvreader.h"
+#include <iostream>
+#include <string>
+#include <random>
+#include <cstring>
+#include <cstdlib>
+using namespace std;
+
+static int failures = 0;
+
+// check <description> <condition>: prints PASS or FAIL depending on the condition
+static void check(const string& description, bool passed) {
+    cout << (passed ? "PASS: " : "FAIL: ") << description << endl;
+    if (!passed) {
+        failures++;
+    }
+}
+
+// This helper method checks that every engine finds the same structural characters as the scalar one
+static bool sameIndices(const string& data) {
+    uint32_t* expected = new uint32_t[data.length() + 1];
+    uint32_t* found = new uint32_t[data.length() + 1];
+    size_t count = findStructural(data.data(), data.length(), expected, SCAN_SCALAR);
+    bool same = true;
+    ScanEngine engines[] = {SCAN_SSE2, SCAN_AVX2}; // An engine the processor lacks falls back to the next best one
+    for (ScanEngine engine : engines) {
+        size_t engineCount = findStructural(data.data(), data.length(), found, engine);
+        same = same && engineCount == count && memcmp(found, expected, count * sizeof(uint32_t)) == 0;
+    }
+    delete[] expected;
+    delete[] found;
+    return same;
+}
+
+// This helper method checks that CSVScanner returns, with every engine, the non-empty lines of the data split like
+// splitCSVLine does (the fields must refer to the same bytes)
+static bool sameLines(const string& data) {
+    ScanEngine engines[] = {SCAN_SCALAR, SCAN_SSE2, SCAN_AVX2};
+    for (ScanEngine engine : engines) {
+        CSVScanner scanner(data.data(), data.data() + data.length(), engine);
+        const char* line = data.data();
+        const char* end = line + data.length();
+        CSVField expected[8], found[8];
+        int fieldCount;
+        while (line < end) {
+            const char* lineEnd = (const char*)memchr(line, '\n', end - line);
+            if (lineEnd == nullptr) lineEnd = end;
+            if (lineEnd != line) {
+                int count = splitCSVLine(line, lineEnd, expected, 8);
+                if (!scanner.nextLine(found, 8, fieldCount) || fieldCount != count) {
+                    return false;
+                }
+                for (int i = 0; i < min(count, 8); i++) {
+                    if (found[i].data != expected[i].data || found[i].length != expected[i].length || found[i].quoted != expected[i].quoted) {
+                        return false;
+                    }
+                }
+            }
+            line = lineEnd + 1;
+        }
+        if (scanner.nextLine(found, 8, fieldCount)) {
+            return false; // A line too many
+        }
+    }
+    return true;
+}
+
+// This helper method returns a line whose quoted field, holding a comma, starts at the given column
+static string quotedAt(size_t column, const string& lineBreak) {
+    return string(column, 'a') + ",\"x,y\",b" + lineBreak;
+}
+
+// main function
+int main() {
+    cout << "Best engine: " << scanEngineName(bestScanEngine()) << endl;
+
+    // Quotes opened before and closed after the end of a 16/32/64-byte block, the comma between them on either side
+    bool indices = true, lines = true;
+    for (size_t column = 0; column < 200; column++) {
+        string data = quotedAt(column, "\n") + quotedAt(column / 2, "\n");
+        indices = indices && sameIndices(data);
+        lines = lines && sameLines(data);
+    }
+    check("quoted commas crossing a block boundary are found by every engine", indices);
+    check("quoted commas crossing a block boundary give the same fields", lines);
+
+    // CRLF: the carriage return stays in the last field, as with splitCSVLine
+    indices = lines = true;
+    for (size_t column = 0; column < 140; column++) {
+        string data = quotedAt(column, "\r\n") + "\r\n" + quotedAt(column + 1, "\r\n") + "last,\"line\"\r";
+        indices = indices && sameIndices(data);
+        lines = lines && sameLines(data);
+    }
+    check("CRLF lines give the same structural characters with every engine", indices);
+    check("CRLF lines give the same fields", lines);
+
+    // An unbalanced quote is closed by the line break, wherever the line break falls in the block
+    indices = lines = true;
+    for (size_t column = 0; column < 140; column++) {
+        string data = string(column, 'a') + ",\"open,field\n" + "next,line,\"x\"\n";
+        indices = indices && sameIndices(data);
+        lines = lines && sameLines(data);
+    }
+    check("a line break closes an unbalanced quote with every engine", indices);
+    check("a line break closes an unbalanced quote in the fields", lines);
+
+    // Random data over the structural characters, of every length up to a few blocks
+    mt19937 rng(13);
+    const char alphabet[] = {'"', ',', '\n', '\r', 'a', 'b', ' ', '"', ','};
+    indices = lines = true;
+    for (size_t length = 0; length < 400; length++) {
+        for (int round = 0; round < 5; round++) {
+            string data;
+            for (size_t i = 0; i < length; i++) {
+                data += alphabet[rng() % sizeof(alphabet)];
+            }
+            indices = indices && sameIndices(data);
+            lines = lines && sameLines(data);
+        }
+    }
+    check("random data gives the same structural characters with every engine", indices);
+    check("random data gives the same fields", lines);
+
+    // Data longer than the window of CSVScanner, so that lines are read across several windows
+    string large;
+    for (long i = 0; large.length() < (3 << 20); i++) {
+        large += "\"Title, " + to_string(i) + "\",Author " + to_string(i % 97) + ",978" + to_string(i) + "," + to_string(1900 + i % 120) + (i % 3 ? "\n" : "\r\n");
+    }
+    check("lines read across several windows give the same fields", sameLines(large));
+
+    if (failures != 0) {
+        cout << failures << " check(s) failed" << endl;
+        return EXIT_FAILURE;
+    }
+    cout << "All checks passed" << endl;
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,93 @@
+#!/bin/sh
+# Name         : snapshot_test.sh
+# Author       : Bertin Iradukunda
+# Version      : 1.0
+# Date Created : October 17, 2026
+# Date Modified: October 17, 2026
+# Description  : Checks that save and load round-trip the catalog, and that load and open reject
+#                a truncated, corrupted or foreign snapshot file
+#============================================================================
+# Run from the project directory after make, with: make test
+
+LCMS=${LCMS:-./lcms}
+OUT=$(mktemp -d)
+trap 'rm -rf "$OUT"' EXIT
+failures=0
+
+# check <description> <command>: prints PASS or FAIL depending on the exit status of the command
+check() {
+	if sh -c "$2"; then
+		echo "PASS: $1"
+	else
+		echo "FAIL: $1"
+		failures=$((failures + 1))
+	fi
+}
+
+# flip <file> <offset>: changes the byte at the given offset of a file, in place
+flip() {
+	byte=$(od -An -tu1 -j "$2" -N1 "$1" | tr -d ' ')
+	printf "\\$(printf '%o' $(((byte + 1) % 256)))" | dd of="$1" bs=1 seek="$2" conv=notrunc 2>/dev/null
+}
+
+# The catalog is exported before the save and after the load, the two exports must be identical
+$LCMS > "$OUT/save.txt" 2>&1 <<SCRIPT
+import booklist.csv
+save $OUT/catalog.snap
+export $OUT/before.csv
+exit
+SCRIPT
+$LCMS > "$OUT/load.txt" 2>&1 <<SCRIPT
+load $OUT/catalog.snap
+export $OUT/after.csv
+findBook The Selfish Gene
+exit
+SCRIPT
+$LCMS > "$OUT/open.txt" 2>&1 <<SCRIPT
+open $OUT/catalog.snap
+findAll Biology
+exit
+SCRIPT
+
+check "save writes every book" \
+	"grep -q '20 books saved successfully' '$OUT/save.txt'"
+check "load reads every book" \
+	"grep -q '20 books loaded successfully' '$OUT/load.txt'"
+check "the loaded catalog exports like the saved one" \
+	"cmp -s '$OUT/before.csv' '$OUT/after.csv'"
+check "the loaded catalog is indexed" \
+	"grep -q 'Author: Richard Dawkins' '$OUT/load.txt'"
+check "open serves the books of the snapshot" \
+	"grep -q 'Title: The Selfish Gene' '$OUT/open.txt'"
+
+# Damaged copies of the snapshot: cut short, one byte of the string table changed, another magic number
+size=$(wc -c < "$OUT/catalog.snap")
+head -c $((size - 7)) "$OUT/catalog.snap" > "$OUT/truncated.snap"
+cp "$OUT/catalog.snap" "$OUT/corrupted.snap"
+flip "$OUT/corrupted.snap" $((size - 3))
+cp "$OUT/catalog.snap" "$OUT/magic.snap"
+flip "$OUT/magic.snap" 0
+
+for damage in truncated corrupted magic; do
+	$LCMS > "$OUT/$damage.txt" 2>&1 <<SCRIPT
+load $OUT/$damage.snap
+open $OUT/$damage.snap
+load $OUT/catalog.snap
+exit
+SCRIPT
+done
+
+check "load and open reject a truncated snapshot" \
+	"[ \$(grep -c 'truncated snapshot' '$OUT/truncated.txt') -eq 2 ]"
+check "load and open reject a corrupted snapshot" \
+	"[ \$(grep -c 'checksum mismatch' '$OUT/corrupted.txt') -eq 2 ]"
+check "load and open reject a file with another magic number" \
+	"[ \$(grep -c 'not a snapshot file' '$OUT/magic.txt') -eq 2 ]"
+check "a rejected snapshot leaves the catalog empty" \
+	"grep -q '20 books loaded successfully' '$OUT/truncated.txt' && grep -q '20 books loaded successfully' '$OUT/corrupted.txt'"
+
+if [ $failures -ne 0 ]; then
+	echo "$failures check(s) failed"
+	exit 1
+fi
+echo "All checks passed"
@@ -2,33 +2,55 @@
 // Author       : Bertin Iradukunda
 // Version      : 1.0
 // Date Created : April 9, 2025
-// Date Modified: June 21, 2025
+// Date Modified: October 16, 2026
 // Description  : Node and Tree class tres representing a hierarchical structure of categories and books
 //============================================================================
 
 #include "tree.h"
 #include "myvector.h"
+#include "snapshot.h"
+#include "csvreader.h"
 #include <iostream>
 #include <sstream> 
 #include <fstream> 
 #include <string>
 #include <cctype>
-#define FUZZY_SEARCH_THRESHOLD 2 // Define a threshold for fuzzy search
+#include <cstring>
+#include <chrono>
+#include <iomanip>
+#define EXPORT_BUFFER_SIZE (1 << 20) // Bytes of records gathered by exportData before each write
+#define PARALLEL_INDEX_MIN_BOOKS 10000 // Fewest books for which ensureSearchIndexes builds the indexes on several threads
+#define LAYOUT_WALK_SHARE 8 // A subtree holding less than 1/8 of the books is walked, rather than the stale layout rebuilt
 using namespace std;
 
+ObjectPool<Node> Node::pool;
+StringPool Node::namePool;
+
 // Constructor to initialize a Node with a given name
 Node::Node(string name) 
 {
-    this->name = name;
+    this->name = namePool.intern(name); // Shared with the other categories of the same name (e.g. in different parents)
+    this->nameKey = namePool.intern(normalize_key(name)); // Normalized name is computed once, when the node is created
     this->bookCount = 0; // Initialize book count to 0
     this->parent = nullptr; // Initialize parent to nullptr
+    this->layoutIndex = 0;
+}
+
+// This constructor initializes a Node from its name and its normalized name, which is not recomputed
+Node::Node(string name, const string& nameKey) 
+{
+    this->name = namePool.intern(name);
+    this->nameKey = namePool.intern(nameKey);
+    this->bookCount = 0;
+    this->parent = nullptr;
+    this->layoutIndex = 0;
 }
 
 // This method returns the category name of the Node
 // It uses recursion to construct the full path. 
 string Node::getCategory(Node* node) 
 {
-    string category = node->name; // Start with the current node's name
+    string category = *node->name; // Start with the current node's name
 
     // If the node has a parent, recursively get the parent's category
     if (node->parent != nullptr) 
@@ -39,56 +61,59 @@ string Node::getCategory(Node* node)
     return category; // Return the full path of the category
 }
 
+// This method renames the Node and updates its normalized name
+void Node::setName(const string& name)
+{
+    const string* oldName = this->name;
+    const string* oldNameKey = this->nameKey;
+    this->name = namePool.intern(name); // Interned before the old ones are released, they may be the same strings
+    this->nameKey = namePool.intern(normalize_key(name));
+    namePool.release(oldName);
+    namePool.release(oldNameKey);
+}
+
+// This method returns the pool of the interned category names
+StringPool& Node::getNamePool()
+{
+    return namePool;
+}
+
 // Destructor to clean up dynamically allocated memory
 // It deletes all child nodes and books asstrociated with the current node
+// Nothing is printed per item: a whole subtree is reported once, by the code deleting it
 Node::~Node() 
 {
     for (int i = 0; i < books.size(); i++) 
     {
-        string bookTitle = books[i]->title; // Get the title of the book
         delete books[i]; // delete each book in the books vector
-        cout << "Book \"" << bookTitle << "\" has been deleted from the library catalog." << endl;
     }
     for (int i = 0; i < children.size(); i++) 
     {
         delete children[i]; // recursively  delete each child node 
     }
-    cout << "Category \"" << name << "\" has been deleted from the library catalog." << endl; 
-    
+    namePool.release(name);
+    namePool.release(nameKey);
 }
 
-// This method calculates the Levenshtein distance between two strings
-// It takes two strings as input and returns the minimum number of single-character edits (insertions,
-// deletions, or substitutions) required to change one string into the other
-int levenshtein_distance(const string &s1, const string &s2) {
-    int len_s1 = s1.length();
-    int len_s2 = s2.length();
-
-    // create a 2D vector to store distances
-    MyVector<MyVector<int>> dist(len_s1 + 1);
-    for (int i = 0; i <= len_s1; ++i) {
-        dist[i].reserve(len_s2 + 1);   // Reserve space for each row
-    }
-
-    // Initialize the first row and column
-    for (int i = 0; i <= len_s1; ++i) {
-        dist[i][0] = i; // Deletion cost
-    }
-    for (int j = 0; j <= len_s2; ++j) {
-        dist[0][j] = j; // Insertion cost
+// This operator takes the memory of a new Node from the pool
+void* Node::operator new(size_t size)
+{
+    if (size != sizeof(Node)) // A slot of the pool holds exactly one Node, a derived class goes to the heap
+    {
+        return ::operator new(size);
     }
+    return pool.allocate();
+}
 
-    // Compute the distances
-    for (int i = 1; i <= len_s1; ++i) {
-        for (int j = 1; j <= len_s2; ++j) {
-            int cost = (s1[i - 1] == s2[j - 1]) ? 0 : 1;
-            dist[i][j] = std::min({dist[i - 1][j] + 1,      // Deletion
-                                   dist[i][j - 1] + 1,      // Insertion
-                                   dist[i - 1][j - 1] + cost}); // Substitution
-        }
+// This operator gives the memory of a deleted Node back to where operator new took it from
+void Node::operator delete(void* pointer, size_t size)
+{
+    if (size != sizeof(Node))
+    {
+        ::operator delete(pointer);
+        return;
     }
-
-    return dist[len_s1][len_s2]; // Return the Levenshtein distance
+    pool.deallocate(pointer);
 }
 
 // This helper method formats a string for CSV output
@@ -100,31 +125,202 @@ string formatCSVString(const string& elem) {
     return elem; // Return as it is if no comma found
 }
 
-// This helper method converts a string to lowercase
-// It iterates through each character and converts it to lowercase and returns the new string
-string toLowerCase(const string& str) {
-    string lowerStr;
-    for (char c : str) {  // Iterate through each character in the string
-        lowerStr += tolower(c);
-    }
-    return lowerStr;
+// This helper method appends a string formatted for CSV output (like formatCSVString) to a buffer
+static void appendCSVString(string& buffer, const char* data, size_t length) {
+    bool quote = memchr(data, ',', length) != nullptr;
+    if (quote) buffer += '"';
+    buffer.append(data, length);
+    if (quote) buffer += '"';
+}
+
+// These helper methods compare a string given by its bytes (e.g. from a column) with a normalized key
+static bool keyEquals(const char* data, size_t length, const string& key) {
+    return length == key.length() && memcmp(data, key.data(), length) == 0;
+}
+
+static bool keyStartsWith(const char* data, size_t length, const string& key) {
+    return length >= key.length() && memcmp(data, key.data(), key.length()) == 0;
 }
 
-// Helper function to remove leading and rear edge whitespace
-string strip_whitespace(const string& str) {
-    size_t start = str.find_first_not_of(" \t\n\r"); // Find the first non-whitespace character
-    size_t end = str.find_last_not_of(" \t\n\r"); // Find the last non-whitespace character
-    return (start == string::npos || end == string::npos) ? "" : str.substr(start, end - start + 1); // Return the substring without leading and rear edge whitespace, if any
+static bool keyContains(const char* data, size_t length, const string& key) {
+    return search(data, data + length, key.begin(), key.end()) != data + length || key.empty();
 }
 
 // Constructor to initialize the Tree with a root Node (Library)
 Tree::Tree(string rootName) {
     root = new Node(rootName); // Create the root node with the given name
+    dictionary = nullptr; // The suggestion dictionary is only built on request
+    bulkLoading = false;
+    lookupIndexesReady = true; // The indexes are maintained book by book
+    searchIndexesReady = true;
+    reaperStop = false;
+    nextSequence = 0;
+    nodeLayoutDirty = true; // The layout is built on the first traversal
+    layoutDirty = true;
 }
 
 // Destructor to clean up the entire Tree
+// The subtrees still queued are freed by the reaper before the rest of the catalog is deleted, then a single summary is printed
+// (none if the catalog holds no book and no category)
 Tree::~Tree() {
+    if (reaper.joinable()) 
+    {
+        {
+            lock_guard<mutex> guard(reaperLock);
+            reaperStop = true;
+        }
+        reaperWake.notify_one();
+        reaper.join(); // Wait for the reaper to empty its queue
+    }
+    auto start = chrono::steady_clock::now();
+    unsigned int books = recountBooks(root);
+    unsigned int categories = countCategories(root) - 1; // The root is not a category of the catalog
     delete root; // Delete the root node, which will recursively delete all its children and books
+    delete dictionary; // Delete the suggestion dictionary, if it was built
+    if (books == 0 && categories == 0) 
+    {
+        return; // Nothing was loaded, there is nothing to report
+    }
+    double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+    ios::fmtflags flags = cout.flags(); // Format of cout, restored once the figures are printed
+    streamsize precision = cout.precision();
+    cout << books << (books == 1 ? " book and " : " books and ") << categories << (categories == 1 ? " category" : " categories")
+         << " deleted from the library catalog in " << fixed << setprecision(2) << ms << " ms" << endl;
+    cout.flags(flags);
+    cout.precision(precision);
+}
+
+// This method rebuilds the Nodes of the flattened layout if a category was added or removed since they were last built
+// The book columns refer to the positions of the Nodes, so they are rebuilt too on the next ensureLayout
+void Tree::ensureNodeLayout() 
+{
+    if (!nodeLayoutDirty) 
+    {
+        return;
+    }
+    layoutNodes.clear();
+    buildNodeLayout_helper(root, 0);
+    nodeLayoutDirty = false;
+    layoutDirty = true;
+}
+
+// This method rebuilds the flattened layout if the Tree changed since it was last built
+// Every mutation only sets the dirty flags, so a burst of changes (e.g. an import) costs a single rebuild
+// The books are appended Node by Node, in the pre-order of layoutNodes
+void Tree::ensureLayout() 
+{
+    ensureNodeLayout();
+    if (!layoutDirty) 
+    {
+        return;
+    }
+    layoutBooks.clear();
+    for (uint32_t position = 0; position < (uint32_t)layoutNodes.size(); position++) 
+    {
+        layoutNodes[position].firstBook = layoutBooks.size();
+        for (Book* book : layoutNodes[position].node->books) 
+        {
+            layoutBooks.add(book);
+        }
+    }
+    layoutDirty = false;
+}
+
+// This method is the recursive part of ensureNodeLayout, it appends a Node and then its subtree
+void Tree::buildNodeLayout_helper(Node* node, uint32_t parent) 
+{
+    uint32_t position = layoutNodes.size();
+    LayoutNode entry = {node, parent, 0, 0};
+    layoutNodes.push_back(entry);
+    node->layoutIndex = position;
+    for (Node* child : node->children) 
+    {
+        buildNodeLayout_helper(child, position);
+    }
+    layoutNodes[position].subtreeEnd = layoutNodes.size();
+}
+
+// This method returns the position of the first book of the Node at the given layout position,
+// which is also the end of the books of the Nodes before it
+uint32_t Tree::layoutBookStart(uint32_t position) 
+{
+    return position < (uint32_t)layoutNodes.size() ? layoutNodes[position].firstBook : layoutBooks.size();
+}
+
+// This method gets the books of the subtree of a Node, in pre-order, as the range [first, last)
+// The range is a slice of the layout while it is up to date, or once the subtree holds a large share of the catalog
+// (the layout is rebuilt then). After a change, the books of a smaller subtree are collected into scratch by walking
+// its Nodes instead, so that a query on a small category does not pay for a rebuild of the layout of the whole catalog
+void Tree::subtreeBooks(Node* node, MyVector<Book*>& scratch, Book* const*& first, Book* const*& last) 
+{
+    if (layoutDirty && node->bookCount * LAYOUT_WALK_SHARE < root->bookCount) 
+    {
+        collectBooks_helper(node, scratch);
+        first = scratch.data();
+        last = first + scratch.size();
+        return;
+    }
+    ensureLayout();
+    uint32_t position = node->layoutIndex;
+    first = layoutBooks.books.data() + layoutNodes[position].firstBook;
+    last = layoutBooks.books.data() + layoutBookStart(layoutNodes[position].subtreeEnd);
+}
+
+// This method queues a detached subtree for the reaper thread, starting the thread if it is not running yet
+void Tree::reap(Node* node) 
+{
+    {
+        lock_guard<mutex> guard(reaperLock);
+        reaperQueue.push_back(node);
+    }
+    if (!reaper.joinable()) 
+    {
+        reaper = thread(&Tree::reaper_loop, this);
+    }
+    reaperWake.notify_one();
+}
+
+// This method queues indexes dropped from the Tree for the reaper thread, starting the thread if it is not running yet
+void Tree::reap(DroppedIndexes* indexes) 
+{
+    {
+        lock_guard<mutex> guard(reaperLock);
+        reaperIndexes.push_back(indexes);
+    }
+    if (!reaper.joinable()) 
+    {
+        reaper = thread(&Tree::reaper_loop, this);
+    }
+    reaperWake.notify_one();
+}
+
+// This method is the loop of the reaper thread: it deletes the queued subtrees until the Tree is destroyed
+// The Nodes and Books are allocated from thread-safe pools, so they can be freed while the command thread keeps allocating
+void Tree::reaper_loop() 
+{
+    unique_lock<mutex> guard(reaperLock);
+    while (true) 
+    {
+        reaperWake.wait(guard, [this] { return reaperStop || !reaperQueue.empty() || !reaperIndexes.empty(); });
+        if (!reaperIndexes.empty()) 
+        {
+            DroppedIndexes* indexes = reaperIndexes[reaperIndexes.size() - 1];
+            reaperIndexes.erase(reaperIndexes.size() - 1);
+            guard.unlock();
+            delete indexes;
+            guard.lock();
+            continue;
+        }
+        if (reaperQueue.empty()) 
+        {
+            return; // Stopped, and nothing left to delete
+        }
+        Node* node = reaperQueue[reaperQueue.size() - 1];
+        reaperQueue.erase(reaperQueue.size() - 1);
+        guard.unlock();
+        delete node; // Free the subtree outside the lock
+        guard.lock();
+    }
 }
 
 // this method returns the root Node of the Tree
@@ -132,6 +328,12 @@ Node* Tree::getRoot() {
     return root; // Return the root node of the tree
 }
 
+// This method returns the number of categories in the Tree, the root (Library) is not counted
+unsigned int Tree::getCategoryCount() 
+{
+    return countCategories(root) - 1;
+}
+
 // This method prints the entire Tree structure
 // It uses a helper function to recursively print the tree with proper formatting
 void Tree::print() {
@@ -152,7 +354,7 @@ void Tree::print_helper(string padding, string pointer, Node *node)
 {
     if (node != nullptr) 
     {
-        cout << padding << pointer << node->name << "(" << node->bookCount << ")" << endl;
+        cout << padding << pointer << *node->name << "(" << node->bookCount << ")" << endl;
 
         if (node != root) 
             padding += (isLastChild(node)) ? "   " : "│  ";
@@ -167,38 +369,62 @@ void Tree::print_helper(string padding, string pointer, Node *node)
 
 // This method creates and inserts a new node with the given name as a child of the specified node
 // It prints an error messtrage if a child/subcategory with the same name already exists in the current node
-void Tree::insert(Node* node, string child_name) 
+Node* Tree::insert(Node* node, string child_name) 
 {
-    // Check if the child name already exists in the current node
-    for (int i = 0; i < node->children.size(); i++) 
+    // Check if the child name already exists in the current node (case insensitive), before anything is allocated
+    // A name that was never interned cannot be the name of any category
+    string nameKey = normalize_key(child_name);
+    const string* key = Node::namePool.find(nameKey);
+    if (key != nullptr && node->childIndex.count(key) > 0) 
     {
-        if (node->children[i]->name == child_name) 
-        {
-            cout << child_name << "' already exists." << endl;
-            return; // Exit if a child with the same name is found
-        }
+        cout << child_name << "' already exists." << endl;
+        return nullptr; // Exit if a child with the same name is found
     }
 
-    Node* newNode = new Node(child_name); // Create a new node with the given name
+    Node* newNode = new Node(child_name, nameKey); // Create a new node with the given name
     newNode->parent = node; // Set the parent of the new node to the current node
     node->children.push_back(newNode); // Add the new node to the children vector
+    node->childIndex[newNode->nameKey] = newNode; // Index the new node by its normalized name
+    nodeLayoutDirty = true;
+    return newNode;
 }
 
 // This Method removes a child Node with the given name from the given node
 void Tree::removeChild(Node* node, string child_name) {
     // Check if the child name exists in the current node
-    for (int i = 0; i < node->children.size(); i++) 
+    Node* child = getChild(node, child_name);
+    for (int i = 0; child != nullptr && i < node->children.size(); i++) 
     {
-        if (node->children[i]->name == child_name) 
+        if (node->children[i] == child) 
         {
-            int Books_toremove = node->children[i]->bookCount; // Get the number of books to remove
-            // Recursively delete the child node and all its descendants
-            delete node->children[i]; 
+            auto start = chrono::steady_clock::now();
+            node->childIndex.erase(child->nameKey); // Remove the child from the parent's index
+            if (child->bookCount * 2 >= root->bookCount && child->bookCount > 0) 
+            {
+                // Most of the catalog goes away: rebuilding the indexes from the books left, on the next lookup or
+                // search, is cheaper than removing the books one by one (a BK-tree walk each)
+                dropIndexes(true);
+            }
+            unsigned int categories = unindexSubtree(child); // Remove the books of the subtree from the catalog-wide indexes
+            int Books_toremove = child->bookCount; // Get the number of books to remove
             node->children.erase(i); // Remove the child from the parent's children vector
+            nodeLayoutDirty = true;
 
             // Update the book count of the parent node
             updateBookCount(node, -Books_toremove); 
 
+            // The child node and all its descendants are deleted in the background
+            string childName = *child->name;
+            child->parent = nullptr;
+            reap(child);
+            double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+            ios::fmtflags flags = cout.flags();
+            streamsize precision = cout.precision();
+            cout << "Category \"" << childName << "\" has been deleted from the library catalog ("
+                 << Books_toremove << " books, " << categories << " categories) in " << fixed << setprecision(2) << ms << " ms" << endl;
+            cout.flags(flags);
+            cout.precision(precision);
+
             return; 
         }
     }
@@ -255,8 +481,7 @@ Node* Tree::createNode(string path)
         if (child == nullptr) 
         {
             // If the child does not exist, create it
-            insert(currentNode, category);
-            child = getChild(currentNode, category); // Get the newly created child
+            child = insert(currentNode, category);
         }
         currentNode = child; // Move to the child node
     }
@@ -266,16 +491,41 @@ Node* Tree::createNode(string path)
 // This method finds and returns a child Node by its name
 Node* Tree::getChild(Node* ptr, string childname) {
 
-    string ToLowerChildName = toLowerCase(strip_whitespace(childname)); // Convert the child name to lowercase and strip whitespace
-    // Check if the child name exists in the current node
-    for (int i = 0; i < ptr->children.size(); i++) 
+    // Look up the normalized child name in the index of the current node (case insensitive)
+    // A name that was never interned cannot be the name of any category
+    const string* key = Node::namePool.find(normalize_key(childname));
+    if (key == nullptr) 
+    {
+        return nullptr;
+    }
+    unordered_map<const string*, Node*>::const_iterator it = ptr->childIndex.find(key);
+    if (it != ptr->childIndex.end()) 
+    {
+        return it->second; // Return the found child node
+    }
+    return nullptr; // Return nullptr if the child is not found
+}
+
+// This method renames a Node and keeps the child index of its parent up to date
+// It returns false (and leaves the node unchanged) if a sibling already has the new name
+bool Tree::renameNode(Node* node, string newName) 
+{
+    Node* parent = node->parent;
+    if (parent != nullptr) 
     {
-        if (toLowerCase(strip_whitespace(ptr->children[i]->name)) == ToLowerChildName) // Make case insensitive comparison
+        Node* sibling = getChild(parent, newName);
+        if (sibling != nullptr && sibling != node) 
         {
-            return ptr->children[i]; // Return the found child node
+            return false; // Another subcategory already uses this name
         }
+        parent->childIndex.erase(node->nameKey);
     }
-    return nullptr; // Return nullptr if the child is not found
+    node->setName(newName); // Update the name and its normalized key
+    if (parent != nullptr) 
+    {
+        parent->childIndex[node->nameKey] = node;
+    }
+    return true;
 }
 
 // This method updates the book count in a Node (subcategory) and its parent Nodes by a given offset
@@ -294,199 +544,1351 @@ void Tree::updateBookCount(Node* ptr, int offset) {
     }
 }
 
-// This method finds a book by its title in a Node
-// It returns the found book and prints its detail or nullptr if not found
-Book* Tree::findBook(Node* node, string bookTitle) 
+// This method adds a book to a Node
+// It updates the book count of the Node and its parents and indexes the book
+void Tree::attachBook(Node* node, Book* book) 
 {
-    if (node == nullptr) 
+    if (bulkLoading) 
     {
-        return nullptr; // Return nullptr if the node is null
+        if (book->isbnKey == 0) // Books with an ISBN-10/13 are checked through the ISBN index instead
+        {
+            bulkKeysOf(node).insert(bookKey(book->title, *book->author, book->isbn));
+        }
+        // The book counts are recomputed by endBulkLoad
     }
-    // Check if the book title is empty
-    if (bookTitle == "") 
+    else 
     {
-        cout << "No title provided. Please enter a book title" << endl; 
-        return nullptr; // Return nullptr if the book title is empty
+        updateBookCount(node, 1); // Update the book count in the node and its parent nodes
     }
-    string ToLowerBookTitle = toLowerCase(strip_whitespace(bookTitle)); // Convert the book title to lowercase and strip whitespace
-    // Check if the book title exists in the current node's books vector
-    for (int i = 0; i < node->books.size(); i++) 
+    node->books.push_back(book); // Add the book to the node's books vector
+    book->category = node;
+    book->sequence = nextSequence++;
+    layoutDirty = true;
+    indexBook(node, book); // Make the book reachable through the catalog-wide indexes
+}
+
+// This method starts a bulk load, the book counts are left as they are until endBulkLoad
+void Tree::beginBulkLoad(unsigned int expectedBooks) 
+{
+    bulkLoading = true;
+    if (searchIndexesReady && root->bookCount > 0 && expectedBooks >= root->bookCount) 
     {
-        string candidate = toLowerCase(strip_whitespace(node->books[i]->title));
-        if (candidate == ToLowerBookTitle ||
-            levenshtein_distance(candidate, ToLowerBookTitle) <= FUZZY_SEARCH_THRESHOLD) // Check for exact match or fuzzy match
-        {
-            cout << "Book found in the library: " << endl;
-            cout << "-------------------------" << endl;
-            node->books[i]->print(); // Print the details of the found book
-            return node->books[i]; // Return the found book
-        }
+        // The load at least doubles the catalog: building the BK-trees and the trigram index once from the whole
+        // catalog, on the first search, costs about as much as inserting the new books and takes that work off the load
+        // (an empty catalog has nothing to drop, its indexes are filled book by book)
+        dropIndexes(false);
     }
+}
 
-    // Recursively search in the children nodes
+// This method finishes a bulk load
+// The book counts of the whole Tree are recomputed in a single post-order pass, instead of walking up to the root for every book
+void Tree::endBulkLoad() 
+{
+    if (!bulkLoading) 
+    {
+        return;
+    }
+    bulkLoading = false;
+    bulkKeys.clear();
+    recountBooks(root);
+}
+
+// This method recomputes the book count of a Node and all its subcategories, and returns it
+unsigned int Tree::recountBooks(Node* node) 
+{
+    unsigned int count = node->books.size();
     for (int i = 0; i < node->children.size(); i++) 
     {
-        Book* foundBook = findBook(node->children[i], bookTitle); // Call the method for each child node
-        if (foundBook != nullptr) 
+        count += recountBooks(node->children[i]);
+    }
+    node->bookCount = count;
+    return count;
+}
+
+// This method returns the number of Nodes (categories) in the subtree of a Node, the Node included
+unsigned int Tree::countCategories(Node* node) 
+{
+    unsigned int count = 1;
+    for (int i = 0; i < node->children.size(); i++) 
+    {
+        count += countCategories(node->children[i]);
+    }
+    return count;
+}
+
+// This method builds the duplicate key of a book (fields separated by a character that cannot be typed in a CSV field)
+string Tree::bookKey(const string& title, const string& author, const string& isbn) 
+{
+    return title + '\x1f' + author + '\x1f' + isbn;
+}
+
+// This method returns the duplicate keys of the books of a Node without an ISBN-10/13, during a bulk load
+// The keys of a Node are hashed the first time it is touched, so that later checks are O(1)
+unordered_set<string>& Tree::bulkKeysOf(Node* node) 
+{
+    unordered_map<Node*, unordered_set<string> >::iterator it = bulkKeys.find(node);
+    if (it == bulkKeys.end()) 
+    {
+        it = bulkKeys.insert(make_pair(node, unordered_set<string>())).first;
+        for (int i = 0; i < node->books.size(); i++) 
         {
-            return foundBook; // Return the found book if it exists in a child node
+            Book* book = node->books[i];
+            if (book->isbnKey == 0) 
+            {
+                it->second.insert(bookKey(book->title, *book->author, book->isbn));
+            }
         }
     }
-    return nullptr; // Return nullptr if the book is not found in the current node or its children
+    return it->second;
 }
 
-
-// This method removes a book by its title from a Node
-// It returns true if the book is removed successfully, otherwise false
-bool Tree::removeBook(Node* node, string bookTitle, Book*& removedBook, string& removedBookCategory) 
+// This method checks if the catalog already holds a book
+// An ISBN-10/13 identifies a book across the whole catalog, and is looked up in the ISBN index. A book without one
+// is compared to the books of its Node: outside of a bulk load they are scanned, comparing the interned authors by address
+bool Tree::containsBook(Node* node, const string& title, const string& author, const string& isbn) 
 {
-    if (node == nullptr) 
+    uint64_t isbnKey = Book::normalizeIsbn(isbn);
+    if (isbnKey != 0) 
     {
-        return false; // Return false if the node is null
+        ensureLookupIndexes();
+        return isbnIndex.count(isbnKey) > 0;
     }
-    // Check if the book title is empty
-    if (bookTitle == "") 
+    if (bulkLoading) 
     {
-        cout << "No title provided. Please enter a book title" << endl; 
-        return false; // Return false if the book title is empty
+        return bulkKeysOf(node).count(bookKey(title, author, isbn)) > 0;
+    }
+    const string* authorId = Book::getAuthorPool().find(author);
+    if (authorId == nullptr) 
+    {
+        return false; // No book of the catalog has this author
     }
-    removedBook = nullptr; // Initialize the removedBook reference to nullptr
-    string ToLowerBookTitle = toLowerCase(strip_whitespace(bookTitle)); // Convert the book title to lowercase
-    // Check if the book title exists in the current node's books vector
     for (int i = 0; i < node->books.size(); i++) 
     {
-        string candidate = toLowerCase(strip_whitespace(node->books[i]->title));
-        if (candidate == ToLowerBookTitle ||
-            levenshtein_distance(candidate, ToLowerBookTitle) <= FUZZY_SEARCH_THRESHOLD) // Check for exact match or fuzzy match
+        Book* book = node->books[i];
+        if (book->author == authorId && book->isbn == isbn && book->title == title) 
         {
-            removedBook = node->books[i]; // Store the found book in the reference parameter
-            removedBookCategory = node-> name; // Store the category of the found book
-            // delete node->books[i]; // Delete the found book
-            node->books.erase(i); // Remove the book from the books vector
-
-            // Update the book count of the parent node
-            updateBookCount(node, -1); 
-
-            return true; // Return true if the book is removed successfully
+            return true;
         }
     }
-    // Recursively search in the children nodes
-    for (int i = 0; i < node->children.size(); i++) 
+    return false;
+}
+
+// This method takes the book at the given position out of a Node, without deleting it
+// It updates the book count of the Node and its parents and removes the book from the indexes
+void Tree::detachBook(Node* node, int index) 
+{
+    Book* book = node->books[index];
+    unindexBook(book);
+    node->books.erase(index); // Remove the book from the books vector
+    book->category = nullptr;
+    layoutDirty = true;
+    if (bulkLoading) 
     {
-        if (removeBook(node->children[i], bookTitle, removedBook, removedBookCategory)) // Call the method for each child node
+        unordered_map<Node*, unordered_set<string> >::iterator it = bulkKeys.find(node);
+        if (it != bulkKeys.end() && book->isbnKey == 0) 
         {
-            return true; // Return true if the book is removed successfully from a child node
+            it->second.erase(bookKey(book->title, *book->author, book->isbn));
         }
     }
-    return false; // Return false if the book is not found
+    else 
+    {
+        updateBookCount(node, -1); // Update the book count in the node and its parent nodes
+    }
 }
 
-// This method prints all books in a Node (category/subcategory) and its children
-void Tree::printAll(Node* node) 
+// This method finds the Node holding the given book and the position of the book in it
+// It returns false if the book is not in the catalog
+bool Tree::locateBook(Book* book, Node*& node, int& index) 
 {
-    // Print the details of each book in the current node
-    for (int i = 0; i < node->books.size(); i++) 
+    if (book->category == nullptr) 
+    {
+        return false; // The book is not in the catalog
+    }
+    node = book->category;
+    for (index = 0; index < node->books.size(); index++) 
     {
-        node->books[i]->print(); // Print the details of the book
+        if (node->books[index] == book) 
+        {
+            return true;
+        }
     }
+    return false;
+}
 
-    // Recursively print all books in the children nodes
-    for (int i = 0; i < node->children.size(); i++) 
+// This method changes the title of a book and moves it to its new key in the title index
+void Tree::retitleBook(Book* book, string newTitle) 
+{
+    Node* node = nullptr;
+    int index = 0;
+    bool indexed = locateBook(book, node, index);
+    if (indexed) 
+    {
+        unindexBook(book);
+    }
+    book->setTitle(newTitle); // Update the title and its normalized key (the layout reads them from the book)
+    if (indexed) 
     {
-        printAll(node->children[i]); // Call the method for each child node
+        indexBook(node, book);
     }
 }
 
-// A recursive method to find all books (containg the keyword in its title or author) and categories that containg the keyword in its name
-// It is case insensitive
-void Tree::find(Node *node, string keyword, MyVector<Node*> &categoriesFound, MyVector<Book*> &booksFound) 
+// This method changes the author of a book and moves it to its new key in the author index
+void Tree::reauthorBook(Book* book, string newAuthor) 
 {
-    if (node == nullptr) 
+    Node* node = nullptr;
+    int index = 0;
+    bool indexed = locateBook(book, node, index);
+    if (indexed) 
+    {
+        unindexBook(book);
+    }
+    book->setAuthor(newAuthor); // Update the author and its normalized key (the layout reads them from the book)
+    if (indexed) 
+    {
+        indexBook(node, book);
+    }
+}
 
+// This method changes the ISBN of a book and moves it to its new key in the ISBN index
+void Tree::changeIsbn(Book* book, string newIsbn) 
+{
+    Node* node = nullptr;
+    int index = 0;
+    bool indexed = locateBook(book, node, index);
+    if (indexed) 
     {
-        return; // Return if the node is null
+        unindexBook(book);
     }
-    // Check if the keyword is empty
-    if (keyword == "") 
+    book->setIsbn(newIsbn); // Update the ISBN and its normalized key (the layout reads them from the book)
+    if (indexed) 
     {
-        cout << "No keyword provid. Please enter a keyword" << endl; 
-        return; // Return if the keyword is empty
+        indexBook(node, book);
     }
-    
-    string lowerKeyword = toLowerCase(strip_whitespace(keyword)); // Convert the keyword to lowercase for case-insensitive comparison
+}
+
+// This method changes the publication year of a book (the layout reads it from the book)
+void Tree::changeYear(Book* book, int newYear) 
+{
+    book->publication_year = newYear;
+}
 
-    // Check if the node name contains the keyword or is a fuzzy match
-    string nodeName = toLowerCase(strip_whitespace(node->name));
-    if (nodeName.find(lowerKeyword) != string::npos ||
-        levenshtein_distance(nodeName, lowerKeyword) <= FUZZY_SEARCH_THRESHOLD)
+// This method finds a book by its normalized ISBN, the first one indexed if several books share it
+BookRef Tree::findIsbn(uint64_t isbnKey) 
+{
+    ensureLookupIndexes();
+    auto it = isbnIndex.find(isbnKey);
+    if (it == isbnIndex.end()) 
     {
-        categoriesFound.push_back(node); // Add the node to the categories found vector
+        BookRef none = {nullptr, nullptr};
+        return none;
     }
+    return it->second;
+}
 
-    // Check if any book in the current node contains the keyword in its title or author, or is a fuzzy match
-    for (int i = 0; i < node->books.size(); i++) 
+// This method adds a book to the catalog-wide indexes
+void Tree::indexBook(Node* node, Book* book) 
+{
+    if (lookupIndexesReady) // Otherwise the book is added when the lookup indexes are built
     {
-        string bookTitle = toLowerCase(strip_whitespace(node->books[i]->title));
-        string bookAuthor = toLowerCase(strip_whitespace(node->books[i]->author));
-        if (bookTitle.find(lowerKeyword) != string::npos ||
-            bookAuthor.find(lowerKeyword) != string::npos ||
-            levenshtein_distance(bookTitle, lowerKeyword) <= FUZZY_SEARCH_THRESHOLD ||
-            levenshtein_distance(bookAuthor, lowerKeyword) <= FUZZY_SEARCH_THRESHOLD)
+        BookRef ref = {node, book};
+        titleIndex.insert(make_pair(book->titleKey, ref));
+        if (book->isbnKey != 0) 
+        {
+            isbnIndex.insert(make_pair(book->isbnKey, ref));
+        }
+        if (dictionary != nullptr) 
         {
-            booksFound.push_back(node->books[i]); // Add the book to the books found vector
+            dictionary->add(book->titleKey); // Keep the suggestion dictionary up to date once it is built
         }
     }
-
-    // Recursively search in the children nodes
-    for (int i = 0; i < node->children.size(); i++) 
+    if (searchIndexesReady) // Likewise for the search indexes
     {
-        find(node->children[i], keyword, categoriesFound, booksFound); // Call the method for each child node
+        titleTree.insert(book->titleKey, book);
+        authorTree.insert(*book->authorKey, book);
+        bookGrams.add(book, book->titleKey, *book->authorKey);
     }
 }
 
-
-// A recursive method to export data from a Node (category/subcategory) and its children to a file
-// It returns the number of books exported
-int Tree::exportData(Node* node, ofstream& file) 
+// This method removes a book from the catalog-wide indexes
+void Tree::unindexBook(Book* book) 
 {
-    if (node == nullptr) 
+    if (lookupIndexesReady) 
     {
-        return -1; // Return -1 if the node is null
+        auto range = titleIndex.equal_range(book->titleKey);
+        for (auto it = range.first; it != range.second; ++it) 
+        {
+            if (it->second.book == book) 
+            {
+                titleIndex.erase(it);
+                break;
+            }
+        }
+        auto isbns = isbnIndex.equal_range(book->isbnKey);
+        for (auto it = isbns.first; it != isbns.second; ++it) 
+        {
+            if (it->second.book == book) 
+            {
+                isbnIndex.erase(it);
+                break;
+            }
+        }
+        if (dictionary != nullptr) 
+        {
+            dictionary->remove(book->titleKey); // The title leaves the dictionary with the last book holding it
+        }
     }
-    // Check if the file is open
-    if (file.fail()) 
+    if (searchIndexesReady) 
     {
-        cerr << "File is not open." << endl;
-        return -1; // Return -1 if the file is not open
+        titleTree.remove(book->titleKey, book);
+        authorTree.remove(*book->authorKey, book);
+        bookGrams.remove(book);
     }
-    
-    int count = 0; // Initialize the count of books exported to 0
+}
 
-    // Write the details of each book in the current node to the file
-    for (int i = 0; i < node->books.size(); i++) 
+// This method builds the title and ISBN indexes if they were deferred (e.g. by loadSnapshot)
+// Both tables are sized for the whole catalog first, so that they are filled without a rehash
+void Tree::ensureLookupIndexes() 
+{
+    if (lookupIndexesReady) 
     {
-        string category = node->getCategory(node);
+        return;
+    }
+    lookupIndexesReady = true;
+    unsigned int books = recountBooks(root); // Also right during a bulk load, whose counts are recomputed at its end anyway
+    titleIndex.reserve(books);
+    isbnIndex.reserve(books);
+    buildLookupIndexes_helper(root);
+}
 
-        // Remove the root name from the category path
-        if (category.find(root->name + "/") == 0) {
-            category = category.substr(root->name.length() + 1);
+// This method is the recursive part of ensureLookupIndexes, the books are added in pre-order
+void Tree::buildLookupIndexes_helper(Node* node) 
+{
+    for (int i = 0; i < node->books.size(); i++) 
+    {
+        Book* book = node->books[i];
+        BookRef ref = {node, book};
+        titleIndex.insert(make_pair(book->titleKey, ref));
+        if (book->isbnKey != 0) 
+        {
+            isbnIndex.insert(make_pair(book->isbnKey, ref));
+        }
+        if (dictionary != nullptr) 
+        {
+            dictionary->add(book->titleKey);
         }
-        // Format the book details for CSV output
-        file << formatCSVString(node->books[i]->title) << "," 
-             << formatCSVString(node->books[i]->author) << "," 
-             << node->books[i]->isbn << "," 
-             << node->books[i]->publication_year << "," 
-             << category << endl;
-        count++; // Increment the count of books exported
     }
-
-    // Recursively export data from the children nodes
     for (int i = 0; i < node->children.size(); i++) 
     {
-        count += exportData(node->children[i], file); // Call the method for each child node and add to the count
+        buildLookupIndexes_helper(node->children[i]);
     }
+}
 
-    return count; // Return the total number of books exported
+// This method builds the fuzzy and substring search indexes if they were deferred (e.g. by loadSnapshot or an import)
+// The books are added in pre-order, the order in which a search visits them. The three indexes do not share
+// anything, so for a large catalog the two BK-trees are built on threads of their own while this one builds the trigram index
+void Tree::ensureSearchIndexes() 
+{
+    if (searchIndexesReady) 
+    {
+        return;
+    }
+    searchIndexesReady = true;
+    MyVector<Book*> books;
+    collectBooks_helper(root, books);
+    auto buildTitles = [this, &books]() {
+        for (Book* book : books) 
+        {
+            titleTree.insert(book->titleKey, book);
+        }
+    };
+    auto buildAuthors = [this, &books]() {
+        for (Book* book : books) 
+        {
+            authorTree.insert(*book->authorKey, book);
+        }
+    };
+    bool parallel = books.size() >= PARALLEL_INDEX_MIN_BOOKS && thread::hardware_concurrency() > 1;
+    thread titles, authors;
+    if (parallel) 
+    {
+        titles = thread(buildTitles);
+        authors = thread(buildAuthors);
+    }
+    else 
+    {
+        buildTitles();
+        buildAuthors();
+    }
+    for (Book* book : books) 
+    {
+        bookGrams.add(book, book->titleKey, *book->authorKey);
+    }
+    if (parallel) 
+    {
+        titles.join();
+        authors.join();
+    }
+}
+
+// This method appends the books of a Node and of its subtree to books, in pre-order
+void Tree::collectBooks_helper(Node* node, MyVector<Book*>& books) 
+{
+    for (int i = 0; i < node->books.size(); i++) 
+    {
+        books.push_back(node->books[i]);
+    }
+    for (int i = 0; i < node->children.size(); i++) 
+    {
+        collectBooks_helper(node->children[i], books);
+    }
+}
+
+// This method returns the book whose title is the closest fuzzy match of titleKey, or nullptr
+// It uses the BK-tree of titles, so only a fraction of the catalog is compared with the query
+// Among the books at the smallest distance, the first one in pre-order is returned, the one the recursive search
+// met first, so that removeBook with a misspelled title removes the same book as findBook shows
+Book* Tree::closestTitle(const string& titleKey) 
+{
+    MyVector<BKMatch> matches;
+    suggestTitles(titleKey, INT_MAX, matches);
+    if (matches.empty()) 
+    {
+        return nullptr;
+    }
+    ensureNodeLayout(); // The categories are ordered by their layout position
+    BKMatch closest = matches[0];
+    for (const BKMatch& match : matches) 
+    {
+        if (match.distance < closest.distance || (match.distance == closest.distance && precedes(match.book, closest.book))) 
+        {
+            closest = match;
+        }
+    }
+    return closest.book;
+}
+
+// This method builds the suggestion dictionary (deletion neighbourhoods) over the titles of the catalog
+// Once built, it is kept up to date with the title index: every book counts its title once, so a title is removed
+// with the last book holding it, and the dictionary is dropped and refilled along with the title index
+void Tree::buildDictionary() 
+{
+    ensureLookupIndexes();
+    delete dictionary;
+    dictionary = new SuggestionDictionary(FUZZY_SEARCH_THRESHOLD);
+    for (auto it = titleIndex.begin(); it != titleIndex.end(); ++it) 
+    {
+        dictionary->add(it->first);
+    }
+}
+
+// This method returns the suggestion dictionary, or nullptr if it has not been built
+const SuggestionDictionary* Tree::getDictionary() 
+{
+    if (dictionary != nullptr) 
+    {
+        ensureLookupIndexes(); // Refill the dictionary if it was dropped
+    }
+    return dictionary;
+}
+
+// This method finds up to maxCount books whose title is a fuzzy match of titleKey, closest first
+// It probes the suggestion dictionary when it is built, and searches the BK-tree of titles otherwise
+void Tree::suggestTitles(const string& titleKey, int maxCount, MyVector<BKMatch>& matches) 
+{
+    if (dictionary != nullptr) 
+    {
+        MyVector<Suggestion> suggestions;
+        ensureLookupIndexes(); // Also refills the dictionary if it was dropped
+        dictionary->lookup(titleKey, suggestions); // Ranked by distance, then alphabetically
+        for (int i = 0; i < suggestions.size() && matches.size() < maxCount; i++) 
+        {
+            auto range = titleIndex.equal_range(suggestions[i].key);
+            for (auto it = range.first; it != range.second && matches.size() < maxCount; ++it) 
+            {
+                BKMatch match = {it->second.book, suggestions[i].distance};
+                matches.push_back(match);
+            }
+        }
+        return;
+    }
+
+    ensureSearchIndexes();
+    MyVector<BKMatch> candidates;
+    titleTree.search(titleKey, FUZZY_SEARCH_THRESHOLD, candidates);
+    // Keep the maxCount closest candidates, ranked like the dictionary (distance, then title)
+    // The sort is stable, so candidates that tie keep the order of the BK-tree search
+    stable_sort(candidates.begin(), candidates.end(), [](const BKMatch& a, const BKMatch& b) {
+        return a.distance < b.distance || (a.distance == b.distance && a.book->titleKey < b.book->titleKey);
+    });
+    for (int i = 0; i < candidates.size() && matches.size() < maxCount; i++) 
+    {
+        matches.push_back(candidates[i]);
+    }
+}
+
+// This method removes every book of a Node and its children from the catalog-wide indexes
+// It returns the number of Nodes (categories) in the subtree
+unsigned int Tree::unindexSubtree(Node* node) 
+{
+    bulkKeys.erase(node); // The Node is about to be deleted
+    for (int i = 0; (lookupIndexesReady || searchIndexesReady) && i < node->books.size(); i++) 
+    {
+        unindexBook(node->books[i]);
+    }
+    unsigned int categories = 1;
+    for (int i = 0; i < node->children.size(); i++) 
+    {
+        categories += unindexSubtree(node->children[i]);
+    }
+    return categories;
+}
+
+// This method empties the search indexes, and the title and ISBN indexes if lookupIndexes is true
+// They are rebuilt from the Tree when they are next needed, their contents are swapped out in O(1) and freed by the reaper thread
+void Tree::dropIndexes(bool lookupIndexes) 
+{
+    DroppedIndexes* dropped = new DroppedIndexes();
+    if (lookupIndexes) 
+    {
+        dropped->titleIndex.swap(titleIndex);
+        dropped->isbnIndex.swap(isbnIndex);
+        if (dictionary != nullptr) 
+        {
+            dropped->dictionary = dictionary;
+            dictionary = new SuggestionDictionary(FUZZY_SEARCH_THRESHOLD); // Still built, refilled with the title index
+        }
+        lookupIndexesReady = false;
+    }
+    dropped->titleTree.swap(titleTree);
+    dropped->authorTree.swap(authorTree);
+    dropped->bookGrams.swap(bookGrams);
+    searchIndexesReady = false;
+    reap(dropped);
+}
+
+// This method returns the path of a Node relative to the root (e.g. "Physics/Cosmology")
+string Tree::categoryPath(Node* node) 
+{
+    string category = node->getCategory(node);
+    // Remove the root name from the category path
+    if (category.find(*root->name + "/") == 0) {
+        category = category.substr(root->name->length() + 1);
+    }
+    return category;
+}
+
+// This method finds a book by its title in a Node
+// It returns the found book and prints its detail or nullptr if not found
+Book* Tree::findBook(Node* node, string bookTitle) 
+{
+    if (node == nullptr) 
+    {
+        return nullptr; // Return nullptr if the node is null
+    }
+    // Check if the book title is empty
+    if (bookTitle == "") 
+    {
+        cout << "No title provided. Please enter a book title" << endl; 
+        return nullptr; // Return nullptr if the book title is empty
+    }
+    string titleKey = normalize_key(bookTitle); // Normalize the title once
+
+    // An exact title is answered by the catalog-wide title index
+    if (node == root) 
+    {
+        Book* book = firstWithTitle(titleKey);
+        if (book != nullptr) 
+        {
+            cout << "Book found in the library: " << endl;
+            cout << "-------------------------" << endl;
+            book->print(); // Print the details of the found book
+            return book;
+        }
+    }
+
+    // Otherwise fall back to the fuzzy search, through the BK-tree of titles for the whole catalog
+    if (node == root) 
+    {
+        Book* closest = closestTitle(titleKey);
+        if (closest != nullptr) 
+        {
+            cout << "Book found in the library: " << endl;
+            cout << "-------------------------" << endl;
+            closest->print(); // Print the details of the found book
+        }
+        return closest;
+    }
+    // or by comparing the title against the precomputed keys of the books of the subtree
+    return findBook_helper(node, titleKey);
+}
+
+// This method returns the first book of the catalog, in pre-order, whose normalized title is titleKey, or nullptr
+// Several books can share a title, the one a scan of the Tree would meet first is picked, as the recursive search did
+Book* Tree::firstWithTitle(const string& titleKey) 
+{
+    ensureLookupIndexes();
+    auto range = titleIndex.equal_range(titleKey);
+    if (range.first == range.second) 
+    {
+        return nullptr;
+    }
+    ensureNodeLayout(); // The categories are ordered by their layout position
+    Book* first = range.first->second.book;
+    for (auto it = range.first; it != range.second; ++it) 
+    {
+        if (precedes(it->second.book, first)) 
+        {
+            first = it->second.book;
+        }
+    }
+    return first;
+}
+
+// This method returns true if the book a comes before the book b in pre-order: its category comes first in the
+// Node layout, or they share a category and a was attached first (the order of the books of a category)
+bool Tree::precedes(const Book* a, const Book* b) 
+{
+    if (a->category != b->category) 
+    {
+        return a->category->layoutIndex < b->category->layoutIndex;
+    }
+    return a->sequence < b->sequence;
+}
+
+// This method is the recursive part of findBook, titleKey is the normalized title to look for
+Book* Tree::findBook_helper(Node* node, const string& titleKey) 
+{
+    // Check if the book title exists in the current node's books vector
+    for (int i = 0; i < node->books.size(); i++) 
+    {
+        const string& candidate = node->books[i]->titleKey;
+        if (candidate == titleKey ||
+            levenshtein_distance_bounded(candidate, titleKey, FUZZY_SEARCH_THRESHOLD) <= FUZZY_SEARCH_THRESHOLD) // Check for exact match or fuzzy match
+        {
+            cout << "Book found in the library: " << endl;
+            cout << "-------------------------" << endl;
+            node->books[i]->print(); // Print the details of the found book
+            return node->books[i]; // Return the found book
+        }
+    }
+
+    // Recursively search in the children nodes
+    for (int i = 0; i < node->children.size(); i++) 
+    {
+        Book* foundBook = findBook_helper(node->children[i], titleKey); // Call the method for each child node
+        if (foundBook != nullptr) 
+        {
+            return foundBook; // Return the found book if it exists in a child node
+        }
+    }
+    return nullptr; // Return nullptr if the book is not found in the current node or its children
+}
+
+
+// This method removes a book by its title from a Node
+// It returns true if the book is removed successfully, otherwise false
+bool Tree::removeBook(Node* node, string bookTitle, Book*& removedBook, string& removedBookCategory) 
+{
+    if (node == nullptr) 
+    {
+        return false; // Return false if the node is null
+    }
+    // Check if the book title is empty
+    if (bookTitle == "") 
+    {
+        cout << "No title provided. Please enter a book title" << endl; 
+        return false; // Return false if the book title is empty
+    }
+    removedBook = nullptr; // Initialize the removedBook reference to nullptr
+    string titleKey = normalize_key(bookTitle);
+
+    // An exact title is answered by the catalog-wide title index
+    if (node == root) 
+    {
+        Book* book = firstWithTitle(titleKey);
+        if (book != nullptr) 
+        {
+            return removeBook(book, removedBook, removedBookCategory);
+        }
+        return removeBook(closestTitle(titleKey), removedBook, removedBookCategory); // Fuzzy match through the BK-tree
+    }
+    return removeBook_helper(node, titleKey, removedBook, removedBookCategory);
+}
+
+// This method removes the given book from the catalog
+// It returns true if the book is removed successfully, otherwise false
+bool Tree::removeBook(Book* book, Book*& removedBook, string& removedBookCategory) 
+{
+    Node* node = nullptr;
+    int index = 0;
+    if (book == nullptr || !locateBook(book, node, index)) 
+    {
+        return false; // The book is not in the catalog
+    }
+    removedBook = book; // Store the book in the reference parameter
+    removedBookCategory = categoryPath(node); // Store the category of the book (full path, so that undo restores it in place)
+    detachBook(node, index); // Take the book out of its category
+    return true;
+}
+
+// This method is the recursive part of removeBook, titleKey is the normalized title to remove
+bool Tree::removeBook_helper(Node* node, const string& titleKey, Book*& removedBook, string& removedBookCategory) 
+{
+    // Check if the book title exists in the current node's books vector
+    for (int i = 0; i < node->books.size(); i++) 
+    {
+        const string& candidate = node->books[i]->titleKey;
+        if (candidate == titleKey ||
+            levenshtein_distance_bounded(candidate, titleKey, FUZZY_SEARCH_THRESHOLD) <= FUZZY_SEARCH_THRESHOLD) // Check for exact match or fuzzy match
+        {
+            removedBook = node->books[i]; // Store the found book in the reference parameter
+            removedBookCategory = categoryPath(node); // Store the category of the found book (full path, so that undo restores it in place)
+            // delete node->books[i]; // Delete the found book
+            detachBook(node, i); // Remove the book from the books vector, the book counts and the indexes
+
+            return true; // Return true if the book is removed successfully
+        }
+    }
+    // Recursively search in the children nodes
+    for (int i = 0; i < node->children.size(); i++) 
+    {
+        if (removeBook_helper(node->children[i], titleKey, removedBook, removedBookCategory)) // Call the method for each child node
+        {
+            return true; // Return true if the book is removed successfully from a child node
+        }
+    }
+    return false; // Return false if the book is not found
+}
+
+// This method prints all books in a Node (category/subcategory) and its children
+void Tree::printAll(Node* node) 
+{
+    // The books of the subtree are one contiguous range, in the order of a pre-order traversal
+    MyVector<Book*> scratch;
+    Book* const* first;
+    Book* const* last;
+    subtreeBooks(node, scratch, first, last);
+    for (Book* const* book = first; book != last; ++book) 
+    {
+        (*book)->print(); // Print the details of the book
+    }
+}
+
+// A recursive method to find all books (containg the keyword in its title or author) and categories that containg the keyword in its name
+// It is case insensitive
+void Tree::find(Node *node, string keyword, MyVector<Node*> &categoriesFound, MyVector<Book*> &booksFound) 
+{
+    if (node == nullptr) 
+
+    {
+        return; // Return if the node is null
+    }
+    // Check if the keyword is empty
+    if (keyword == "") 
+    {
+        cout << "No keyword provid. Please enter a keyword" << endl; 
+        return; // Return if the keyword is empty
+    }
+    
+    // Convert the keyword to lowercase once, for case-insensitive comparison against the precomputed keys
+    string keywordKey = normalize_key(keyword);
+
+    // A subtree is searched by visiting all its categories and books
+    if (node != root) 
+    {
+        find_scan(node, keywordKey, nullptr, true, categoriesFound, booksFound);
+        return;
+    }
+
+    // For the whole catalog, the fuzzy matches of titles and authors are collected from the BK-trees up front
+    ensureSearchIndexes();
+    MyVector<BKMatch> matches;
+    titleTree.search(keywordKey, FUZZY_SEARCH_THRESHOLD, matches);
+    authorTree.search(keywordKey, FUZZY_SEARCH_THRESHOLD, matches);
+
+    // and the substring matches from the trigram index (keywords of 3 characters or more)
+    MyVector<Book*> candidates;
+    if (!bookGrams.candidates(keywordKey, candidates)) 
+    {
+        // Keyword too short for the trigram index: scan every book, using the BK-tree hits for the fuzzy part
+        unordered_set<Book*> fuzzyHits;
+        for (int i = 0; i < matches.size(); i++) 
+        {
+            fuzzyHits.insert(matches[i].book);
+        }
+        find_scan(node, keywordKey, &fuzzyHits, true, categoriesFound, booksFound);
+        return;
+    }
+
+    // Categories are still visited (there are far fewer categories than books), books are not
+    find_scan(node, keywordKey, nullptr, false, categoriesFound, booksFound);
+
+    // Verify the candidates of the trigram index with the substring test
+    int firstFound = booksFound.size();
+    unordered_set<Book*> added;
+    for (Book* book : candidates) 
+    {
+        if (book->titleKey.find(keywordKey) != string::npos || book->authorKey->find(keywordKey) != string::npos) 
+        {
+            booksFound.push_back(book); // Add the book to the books found vector
+            added.insert(book);
+        }
+    }
+    // Then add the fuzzy matches that do not contain the keyword
+    for (const BKMatch& match : matches) 
+    {
+        if (added.insert(match.book).second) 
+        {
+            booksFound.push_back(match.book);
+        }
+    }
+    // The books are reported in pre-order, as a scan of the subtree would: by the position of their category
+    // in the Node layout (built by find_scan above), then in the order of the books of the category
+    sort(booksFound.begin() + firstFound, booksFound.end(), precedes);
+}
+
+// This method is the scanning part of find, keywordKey is the normalized keyword
+// fuzzyHits holds the books already known to be fuzzy matches, if it is nullptr the distances are computed here
+// If scanBooks is false, only the categories are searched
+// The categories and the books of the subtree are scanned as two contiguous ranges (pre-order, like a recursive walk)
+void Tree::find_scan(Node *node, const string& keywordKey, const unordered_set<Book*>* fuzzyHits, bool scanBooks, MyVector<Node*> &categoriesFound, MyVector<Book*> &booksFound) 
+{
+    ensureNodeLayout(); // The books are gathered below, only if they are scanned
+    uint32_t first = node->layoutIndex;
+    uint32_t end = layoutNodes[first].subtreeEnd;
+
+    // Check if the node names contain the keyword or are a fuzzy match
+    for (uint32_t n = first; n < end; n++) 
+    {
+        Node* category = layoutNodes[n].node;
+        if (category->nameKey->find(keywordKey) != string::npos ||
+            levenshtein_distance_bounded(*category->nameKey, keywordKey, FUZZY_SEARCH_THRESHOLD) <= FUZZY_SEARCH_THRESHOLD)
+        {
+            categoriesFound.push_back(category); // Add the node to the categories found vector
+        }
+    }
+    if (!scanBooks) 
+    {
+        return;
+    }
+
+    // Check if any book of the subtree contains the keyword in its title or author, or is a fuzzy match
+    // Only the normalized title and author of each book are read
+    MyVector<Book*> scratch;
+    Book* const* firstBook;
+    Book* const* lastBook;
+    subtreeBooks(node, scratch, firstBook, lastBook);
+    for (Book* const* it = firstBook; it != lastBook; ++it) 
+    {
+        Book* book = *it;
+        const string& title = book->titleKey;
+        const string& author = *book->authorKey;
+        if (keyContains(title.data(), title.length(), keywordKey) ||
+            keyContains(author.data(), author.length(), keywordKey) ||
+            (fuzzyHits != nullptr ? fuzzyHits->count(book) > 0 :
+             (levenshtein_distance_bounded(title, keywordKey, FUZZY_SEARCH_THRESHOLD) <= FUZZY_SEARCH_THRESHOLD ||
+              levenshtein_distance_bounded(author, keywordKey, FUZZY_SEARCH_THRESHOLD) <= FUZZY_SEARCH_THRESHOLD)))
+        {
+            booksFound.push_back(book); // Add the book to the books found vector
+        }
+    }
+}
+
+
+// Match scores of a ranked search (lower is better), an edit distance d scores MATCH_SUBSTRING + d
+#define MATCH_EXACT 0
+#define MATCH_PREFIX 1
+#define MATCH_SUBSTRING 2
+
+// This method scores a book against a normalized keyword, using the best of its title and author
+// It returns -1 if neither of them matches with a score of at most maxScore
+int Tree::scoreBook(Book* book, const string& keywordKey, int maxScore) 
+{
+    return scoreKeys(book->titleKey.data(), book->titleKey.length(), book->authorKey->data(), book->authorKey->length(), keywordKey, maxScore);
+}
+
+// This method scores a normalized title and author given by their bytes (e.g. from the columns of the layout)
+int Tree::scoreKeys(const char* title, size_t titleLength, const char* author, size_t authorLength, const string& keywordKey, int maxScore) 
+{
+    if (keyEquals(title, titleLength, keywordKey) || keyEquals(author, authorLength, keywordKey)) 
+    {
+        return MATCH_EXACT;
+    }
+    if (maxScore >= MATCH_PREFIX && (keyStartsWith(title, titleLength, keywordKey) ||
+                                     keyStartsWith(author, authorLength, keywordKey))) 
+    {
+        return MATCH_PREFIX;
+    }
+    if (maxScore >= MATCH_SUBSTRING && (keyContains(title, titleLength, keywordKey) || keyContains(author, authorLength, keywordKey))) 
+    {
+        return MATCH_SUBSTRING;
+    }
+    // Only the distances that can still reach maxScore are computed (the bounded engine stops past them)
+    int maxDistance = min(maxScore - MATCH_SUBSTRING, FUZZY_SEARCH_THRESHOLD);
+    if (maxDistance < 1) 
+    {
+        return -1;
+    }
+    int distance = min(levenshtein_distance_bounded(title, titleLength, keywordKey.data(), keywordKey.length(), maxDistance),
+                       levenshtein_distance_bounded(author, authorLength, keywordKey.data(), keywordKey.length(), maxDistance));
+    return (distance <= maxDistance) ? MATCH_SUBSTRING + distance : -1;
+}
+
+// This method finds the count best matching books of the catalog for a keyword, best first
+// The candidates are scored tier by tier (exact, prefix/substring, edit distance), each tier coming from an index,
+// and a tier is only searched while it can still produce a book better than the worst one kept
+void Tree::findTop(string keyword, int count, MyVector<ScoredBook> &results) 
+{
+    string keywordKey = normalize_key(keyword);
+    if (keywordKey.empty() || count <= 0) 
+    {
+        return; // Nothing to rank
+    }
+    ensureLookupIndexes();
+    ensureSearchIndexes();
+    ensureNodeLayout(); // The candidates of each tier are offered in pre-order
+    TopBooks top(count);
+    unordered_set<Book*> scored; // Books already scored by a previous tier (their first score is their best)
+
+    // Exact titles come from the title index, exact authors from the author BK-tree (radius 0)
+    // The heap breaks ties by the order of the offers, so the books of a tier are offered in pre-order, as findTop_scan does,
+    // and the books kept among equal scores do not depend on the order of the hash table or of the trees
+    MyVector<Book*> exact;
+    auto range = titleIndex.equal_range(keywordKey);
+    for (auto it = range.first; it != range.second; ++it) 
+    {
+        if (scored.insert(it->second.book).second) 
+        {
+            exact.push_back(it->second.book);
+        }
+    }
+    MyVector<BKMatch> matches;
+    authorTree.search(keywordKey, 0, matches);
+    for (int i = 0; i < matches.size(); i++) 
+    {
+        if (scored.insert(matches[i].book).second) 
+        {
+            exact.push_back(matches[i].book);
+        }
+    }
+    sort(exact.begin(), exact.end(), precedes);
+    for (Book* book : exact) 
+    {
+        top.offer(book, MATCH_EXACT);
+    }
+
+    // Prefix and substring matches are verified from the candidates of the trigram index
+    MyVector<Book*> candidates;
+    if (top.worstScore() > MATCH_PREFIX && !bookGrams.candidates(keywordKey, candidates)) 
+    {
+        // Keyword too short for the trigram index: every book is scored, distances included
+        findTop_scan(root, keywordKey, top);
+        top.drain(results);
+        return;
+    }
+    sort(candidates.begin(), candidates.end(), precedes);
+    for (int i = 0; i < candidates.size() && top.worstScore() > MATCH_PREFIX; i++) 
+    {
+        Book* book = candidates[i];
+        if (scored.count(book) > 0) 
+        {
+            continue;
+        }
+        int score = scoreBook(book, keywordKey, MATCH_SUBSTRING);
+        if (score >= 0) 
+        {
+            scored.insert(book);
+            top.offer(book, score);
+        }
+    }
+
+    // Fuzzy matches come from the BK-trees, searched with the smallest radius that can still enter the heap
+    int maxDistance = min(top.worstScore() - MATCH_SUBSTRING - 1, FUZZY_SEARCH_THRESHOLD);
+    if (maxDistance >= 1) 
+    {
+        MyVector<BKMatch> fuzzyMatches;
+        titleTree.search(keywordKey, maxDistance, fuzzyMatches);
+        authorTree.search(keywordKey, maxDistance, fuzzyMatches);
+        MyVector<Book*> fuzzy;
+        for (int i = 0; i < fuzzyMatches.size(); i++) 
+        {
+            if (scored.insert(fuzzyMatches[i].book).second) 
+            {
+                fuzzy.push_back(fuzzyMatches[i].book);
+            }
+        }
+        sort(fuzzy.begin(), fuzzy.end(), precedes);
+        for (Book* book : fuzzy) 
+        {
+            int score = scoreBook(book, keywordKey, min(top.worstScore() - 1, MATCH_SUBSTRING + maxDistance));
+            if (score >= 0) 
+            {
+                top.offer(book, score);
+            }
+        }
+    }
+    top.drain(results);
+}
+
+// This method is the scanning part of findTop (keywords too short for the trigram index)
+// Every book is scored against the worst score kept, and the scan stops once only exact matches can enter
+void Tree::findTop_scan(Node* node, const string& keywordKey, TopBooks& top) 
+{
+    MyVector<Book*> scratch;
+    Book* const* first;
+    Book* const* last;
+    subtreeBooks(node, scratch, first, last);
+    for (Book* const* it = first; it != last; ++it) 
+    {
+        int maxScore = min(top.worstScore() - 1, MATCH_SUBSTRING + FUZZY_SEARCH_THRESHOLD);
+        if (maxScore <= MATCH_EXACT) 
+        {
+            return; // The heap is full of exact matches
+        }
+        Book* book = *it;
+        int score = scoreKeys(book->titleKey.data(), book->titleKey.length(), book->authorKey->data(), book->authorKey->length(), keywordKey, maxScore);
+        if (score > MATCH_EXACT) // Exact matches were already offered from the indexes
+        {
+            top.offer(book, score);
+        }
+    }
+}
+
+//==========================================================
+// Constructor to initialize an empty heap keeping at most capacity books
+TopBooks::TopBooks(int capacity) : capacity(capacity), offered(0) {}
+
+// This method returns true if the entry a ranks below the entry b (higher score, or same score offered later)
+bool TopBooks::worse(const Entry& a, const Entry& b) 
+{
+    return a.score > b.score || (a.score == b.score && a.order > b.order);
+}
+
+// This method returns the score a book must beat to enter the heap
+int TopBooks::worstScore() 
+{
+    return (heap.size() < capacity) ? INT_MAX : heap[0].score;
+}
+
+// This method offers a book to the heap, it replaces the worst kept book once the heap is full
+bool TopBooks::offer(Book* book, int score) 
+{
+    Entry entry = {book, score, offered++};
+    if (heap.size() < capacity) 
+    {
+        heap.push_back(entry);
+        siftUp(heap.size() - 1);
+        return true;
+    }
+    if (!worse(heap[0], entry)) 
+    {
+        return false; // Not better than the worst kept book
+    }
+    heap[0] = entry;
+    siftDown(0);
+    return true;
+}
+
+// This method moves an entry up until its parent ranks below it
+void TopBooks::siftUp(int pos) 
+{
+    while (pos > 0 && worse(heap[pos], heap[(pos - 1) / 2])) 
+    {
+        Entry tmp = heap[pos];
+        heap[pos] = heap[(pos - 1) / 2];
+        heap[(pos - 1) / 2] = tmp;
+        pos = (pos - 1) / 2;
+    }
+}
+
+// This method moves an entry down until both its children rank above it
+void TopBooks::siftDown(int pos) 
+{
+    while (true) 
+    {
+        int worst = pos;
+        int left = 2 * pos + 1, right = 2 * pos + 2;
+        if (left < heap.size() && worse(heap[left], heap[worst])) worst = left;
+        if (right < heap.size() && worse(heap[right], heap[worst])) worst = right;
+        if (worst == pos) 
+        {
+            return;
+        }
+        Entry tmp = heap[pos];
+        heap[pos] = heap[worst];
+        heap[worst] = tmp;
+        pos = worst;
+    }
+}
+
+// This method moves the kept books to results, best first
+// The heap pops the worst book first, so the results are filled from the back
+void TopBooks::drain(MyVector<ScoredBook>& results) 
+{
+    int first = results.size();
+    for (int i = 0; i < heap.size(); i++) 
+    {
+        ScoredBook placeholder = {nullptr, 0};
+        results.push_back(placeholder);
+    }
+    for (int i = results.size() - 1; i >= first; i--) 
+    {
+        ScoredBook scoredBook = {heap[0].book, heap[0].score};
+        results[i] = scoredBook;
+        heap[0] = heap[heap.size() - 1];
+        heap.erase(heap.size() - 1);
+        siftDown(0);
+    }
+}
+
+
+// A method to export data from a Node (category/subcategory) and its children to a file
+// It returns the number of books exported
+// The records are appended to a large buffer written in big blocks, and the path of each category is built once
+int Tree::exportData(Node* node, ofstream& file) 
+{
+    if (node == nullptr) 
+    {
+        return -1; // Return -1 if the node is null
+    }
+    // Check if the file is open
+    if (file.fail()) 
+    {
+        cerr << "File is not open." << endl;
+        return -1; // Return -1 if the file is not open
+    }
+
+    string buffer; // Records waiting to be written
+    buffer.reserve(EXPORT_BUFFER_SIZE + EXPORT_BUFFER_SIZE / 8);
+
+    // The categories of the subtree are a contiguous range of the layout, in pre-order: the path of a category
+    // is built once, from the path of its parent (the root name is not part of the exported paths)
+    ensureNodeLayout();
+    uint32_t first = node->layoutIndex;
+    uint32_t end = layoutNodes[first].subtreeEnd;
+    MyVector<string> paths(end - first);
+    paths.push_back(categoryPath(node));
+    for (uint32_t n = first + 1; n < end; n++) 
+    {
+        const LayoutNode& entry = layoutNodes[n];
+        if (layoutNodes[entry.parent].node == root) 
+        {
+            paths.push_back(*entry.node->name);
+        }
+        else 
+        {
+            paths.push_back(paths[entry.parent - first] + '/' + *entry.node->name);
+        }
+    }
+
+    // The books of the subtree are one contiguous range too, in the same order
+    MyVector<Book*> scratch;
+    Book* const* firstBook;
+    Book* const* lastBook;
+    subtreeBooks(node, scratch, firstBook, lastBook);
+    int count = 0; // Initialize the count of books exported to 0
+    for (Book* const* it = firstBook; it != lastBook; ++it) 
+    {
+        // Append the details of the book to the buffer, formatted for CSV output
+        const Book* book = *it;
+        appendCSVString(buffer, book->title.data(), book->title.length());
+        buffer += ',';
+        appendCSVString(buffer, book->author->data(), book->author->length());
+        buffer += ',';
+        buffer += book->isbn;
+        buffer += ',';
+        buffer += to_string(book->publication_year);
+        buffer += ',';
+        buffer += paths[book->category->layoutIndex - first];
+        buffer += '\n';
+        count++; // Increment the count of books exported
+        if (buffer.size() >= EXPORT_BUFFER_SIZE) 
+        {
+            file.write(buffer.data(), buffer.size()); // One big write instead of a flush per record
+            buffer.clear();
+        }
+    }
+    file.write(buffer.data(), buffer.size()); // Write the last records
+    return count; // Return the total number of books exported
+}
+
+// This helper method adds a string to the string table of a snapshot, identical strings are stored once
+static SnapshotString snapshotString(const string& str, string& strings, unordered_map<string, uint32_t>& offsets) 
+{
+    unordered_map<string, uint32_t>::iterator it = offsets.find(str);
+    if (it == offsets.end()) 
+    {
+        it = offsets.insert(make_pair(str, (uint32_t)strings.size())).first;
+        strings += str;
+    }
+    SnapshotString ref = {it->second, (uint32_t)str.length()};
+    return ref;
+}
+
+// This method saves the catalog to a binary snapshot (see snapshot.h), it returns the number of books saved
+int Tree::saveSnapshot(const string& path, string& error) 
+{
+    string body, books, strings; // Sections of the file: nodes (then the other sections appended), books, string table
+    unordered_map<string, uint32_t> offsets;
+    saveSnapshot_helper(root, SNAPSHOT_NONE, body, books, strings, offsets);
+    if (strings.size() > 0xFFFFFFFFu) 
+    {
+        error = "catalog too large for a snapshot";
+        return -1;
+    }
+
+    SnapshotHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, SNAPSHOT_MAGIC, 8);
+    header.version = SNAPSHOT_VERSION;
+    header.nodeCount = body.size() / sizeof(SnapshotNode);
+    header.bookCount = books.size() / sizeof(SnapshotBook);
+    header.stringBytes = strings.size();
+    body += books;
+    body += strings;
+    header.totalSize = sizeof(header) + body.size();
+    header.checksum = snapshotChecksum(body.data(), body.size());
+
+    ofstream file(path, ios::binary);
+    file.write((const char*)&header, sizeof(header));
+    file.write(body.data(), body.size());
+    file.close();
+    if (file.fail()) 
+    {
+        error = "could not write " + path;
+        return -1;
+    }
+    return header.bookCount;
+}
+
+// This method is the recursive part of saveSnapshot, it appends a Node (pre-order) and its books, then its subtree
+// It returns the index of the Node
+uint32_t Tree::saveSnapshot_helper(Node* node, uint32_t parent, string& nodes, string& books, string& strings, unordered_map<string, uint32_t>& offsets) 
+{
+    uint32_t index = nodes.size() / sizeof(SnapshotNode);
+    SnapshotNode record;
+    record.name = snapshotString(*node->name, strings, offsets);
+    record.nameKey = snapshotString(*node->nameKey, strings, offsets);
+    record.parent = parent;
+    record.firstBook = books.size() / sizeof(SnapshotBook);
+    record.bookCount = node->books.size();
+    record.totalBooks = node->bookCount;
+    nodes.append((const char*)&record, sizeof(record)); // subtreeEnd is filled in once the subtree is written
+
+    for (int i = 0; i < node->books.size(); i++) 
+    {
+        Book* book = node->books[i];
+        SnapshotBook bookRecord;
+        bookRecord.title = snapshotString(book->title, strings, offsets);
+        bookRecord.author = snapshotString(*book->author, strings, offsets);
+        bookRecord.isbn = snapshotString(book->isbn, strings, offsets);
+        bookRecord.titleKey = snapshotString(book->titleKey, strings, offsets);
+        bookRecord.authorKey = snapshotString(*book->authorKey, strings, offsets);
+        bookRecord.year = book->publication_year;
+        bookRecord.node = index;
+        books.append((const char*)&bookRecord, sizeof(bookRecord));
+    }
+    for (int i = 0; i < node->children.size(); i++) 
+    {
+        saveSnapshot_helper(node->children[i], index, nodes, books, strings, offsets);
+    }
+
+    record.subtreeEnd = nodes.size() / sizeof(SnapshotNode);
+    memcpy(&nodes[index * sizeof(SnapshotNode)], &record, sizeof(record));
+    return index;
+}
+
+// This helper method identifies a string of the snapshot table by its offset and length
+static uint64_t snapshotStringId(const SnapshotString& str) 
+{
+    return ((uint64_t)str.offset << 32) | str.length;
+}
+
+// This method loads a binary snapshot into the (empty) catalog, it returns the number of books loaded
+// The file is mapped and validated, then the Nodes and Books are created in a single pass with their counts and
+// normalized keys taken from the snapshot. Each distinct author is interned once, with a reference per book, and the
+// indexes are not filled: the title and ISBN indexes are built on the first lookup, the fuzzy and substring ones on the first search
+int Tree::loadSnapshot(const string& path, string& error) 
+{
+    if (!isEmpty()) 
+    {
+        error = "the catalog is not empty";
+        return -1;
+    }
+    MappedFile file;
+    if (!file.open(path)) 
+    {
+        error = "could not open " + path;
+        return -1;
+    }
+    const char* reason = validateSnapshot(file.begin(), file.size());
+    if (reason != nullptr) 
+    {
+        error = reason;
+        return -1;
+    }
+
+    SnapshotHeader header;
+    memcpy(&header, file.begin(), sizeof(header));
+    const SnapshotNode* nodes = (const SnapshotNode*)(file.begin() + sizeof(SnapshotHeader));
+    const SnapshotBook* books = (const SnapshotBook*)(nodes + header.nodeCount);
+    const char* strings = (const char*)(books + header.bookCount);
+
+    lookupIndexesReady = false;
+    searchIndexesReady = false;
+    nodeLayoutDirty = true;
+    titleIndex.clear();
+    isbnIndex.clear();
+    if (dictionary != nullptr) 
+    {
+        dictionary->clear(); // Refilled with the title index
+    }
+
+    // The authors and normalized authors are counted by string of the table, then interned with all their references
+    unordered_map<uint64_t, pair<size_t, const string*> > authors;
+    for (uint32_t b = 0; b < header.bookCount; b++) 
+    {
+        authors[snapshotStringId(books[b].author)].first++;
+        authors[snapshotStringId(books[b].authorKey)].first++;
+    }
+    for (auto it = authors.begin(); it != authors.end(); ++it) 
+    {
+        uint32_t offset = (uint32_t)(it->first >> 32), length = (uint32_t)it->first;
+        it->second.second = Book::getAuthorPool().intern(string(strings + offset, length), it->second.first);
+    }
+
+    MyVector<Node*> created; // Nodes by snapshot index, the snapshot root is the root of the Tree
+    created.reserve(header.nodeCount);
+    created.push_back(root);
+    for (uint32_t i = 1; i < header.nodeCount; i++) 
+    {
+        Node* parent = created[nodes[i].parent];
+        Node* node = new Node(string(strings + nodes[i].name.offset, nodes[i].name.length));
+        node->parent = parent;
+        parent->children.push_back(node);
+        parent->childIndex[node->nameKey] = node;
+        created.push_back(node);
+    }
+    for (uint32_t i = 0; i < header.nodeCount; i++) 
+    {
+        Node* node = created[i];
+        node->bookCount = nodes[i].totalBooks;
+        node->books.reserve(nodes[i].bookCount);
+        for (uint32_t b = nodes[i].firstBook; b < nodes[i].firstBook + nodes[i].bookCount; b++) 
+        {
+            const SnapshotBook& record = books[b];
+            Book* book = new Book(string(strings + record.title.offset, record.title.length),
+                                  authors[snapshotStringId(record.author)].second,
+                                  string(strings + record.isbn.offset, record.isbn.length), record.year,
+                                  string(strings + record.titleKey.offset, record.titleKey.length),
+                                  authors[snapshotStringId(record.authorKey)].second);
+            node->books.push_back(book);
+            book->category = node;
+            book->sequence = nextSequence++;
+            indexBook(node, book);
+        }
+    }
+    return header.bookCount;
 }
 
 // This method checks if the Tree is empty
@@ -497,4 +1899,4 @@ bool Tree::isEmpty()
     return (root->children.size() == 0 && root->books.size() == 0);
 }
 //=============================================================================
-// End of file
\ No newline at end of file
+// End of file
@@ -3,42 +3,184 @@
 
 #include <string>
 #include<algorithm>
+#include <unordered_map>
+#include <unordered_set>
+#include <climits>
+#include <cstdint>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 #include "myvector.h"
 #include "book.h"
+#include "bookcolumns.h"
+#include "objectpool.h"
+#include "stringpool.h"
+#include "fuzzy.h"
+#include "bktree.h"
+#include "symspell.h"
+#include "trigram.h"
 
 using namespace std;
 
+// Children and books a Node stores inline, before its vectors allocate (most categories have a few of each)
+#define NODE_INLINE_CHILDREN 4
+#define NODE_INLINE_BOOKS 4
+
 // Class representing a Node in the Tree
 class Node 
 {
 	private:
-	    string name;                // Name of the Node (represents a category or subcategories)
-	    MyVector<Node*> children;   // List of child Nodes (subcategories)
-	    MyVector<Book*> books;      // List of books stored in this Node
+	    const string* name;         // Name of the Node (represents a category or subcategories), interned in namePool
+	    const string* nameKey;      // Normalized name (lowercase, stripped) used by lookup and search, interned in namePool
+	    MyVector<Node*, NODE_INLINE_CHILDREN> children; // List of child Nodes (subcategories)
+	    unordered_map<const string*, Node*> childIndex; // Child Nodes indexed by their interned normalized name (compared by address)
+	    MyVector<Book*, NODE_INLINE_BOOKS> books; // List of books stored in this Node
 	    unsigned int bookCount;     // Count of books in this Node (Category) and its all subcategories
 	    Node* parent;               // Pointer to the parent Node (nullptr for the root)
+	    uint32_t layoutIndex;       // Position of the Node in the flattened layout of the Tree (valid while the layout is up to date)
+	    static ObjectPool<Node> pool; // Slabs every Node is allocated from
+	    static StringPool namePool;   // Interned names and normalized names of all the Nodes
 
 	public:
 	    // Constructor to initialize a Node with a given name
 	    Node(string name);
 
+	    // Constructor to initialize a Node with a given name whose normalized name is already computed
+	    Node(string name, const string& nameKey);
+
 	    // Method to get the category name of the Node
 	    string getCategory(Node* node);
 
-	    // Destructor to clean up dynamically allocated memory
+	    // Method to rename the Node, it keeps the normalized name up to date
+	    void setName(const string& name);
+
+	    // Destructor to free the books and children of the Node (silently, the caller reports what was deleted)
 	    ~Node();
 
+	    // Method to get the pool of the interned category names (e.g. for statistics)
+	    static StringPool& getNamePool();
+
+	    // Nodes are not copied (each one holds references to the interned strings)
+	    Node(const Node&) = delete;
+	    Node& operator=(const Node&) = delete;
+
+	    // Nodes are allocated from the pool instead of one by one on the heap
+	    static void* operator new(size_t size);
+	    static void operator delete(void* pointer, size_t size);
+
 	    // Friend classes to allow access to private members
 	    friend class Tree;
 	    friend class LCMS;
 };
 
+//==========================================================
+// Location of a book in the catalog: the category Node holding it and the Book itself
+struct BookRef 
+{
+	    Node* node;   // Category (Node) the book is stored in
+	    Book* book;   // The book
+};
+
+//==========================================================
+// Catalog-wide indexes taken out of the Tree as a whole by dropIndexes, the reaper thread frees them
+struct DroppedIndexes 
+{
+	    unordered_multimap<string, BookRef> titleIndex;
+	    unordered_multimap<uint64_t, BookRef> isbnIndex;
+	    BKTree titleTree;
+	    BKTree authorTree;
+	    TrigramIndex<Book*> bookGrams;
+	    SuggestionDictionary* dictionary; // Dropped with the title index, if it was built
+
+	    DroppedIndexes() : dictionary(nullptr) {}
+	    ~DroppedIndexes() { delete dictionary; }
+};
+
+//==========================================================
+// Entry of the flattened layout of the Tree: the Nodes in pre-order, their books grouped in the same order,
+// so that the subtree of the Node at position p is [p, subtreeEnd) and its books one contiguous range too
+struct LayoutNode 
+{
+	    Node* node;            // The category
+	    uint32_t parent;       // Position of its parent in the layout (the root has itself as parent)
+	    uint32_t subtreeEnd;   // Position just past its last descendant
+	    uint32_t firstBook;    // Position of its first book in the book array of the layout
+};
+
+//==========================================================
+// A book returned by a ranked (top-k) search, with its match score (lower is better):
+// 0 exact title/author, 1 prefix, 2 substring, 2 + d for an edit distance d
+struct ScoredBook 
+{
+	    Book* book;   // The book
+	    int score;    // Match score of its title or author (the best of the two)
+};
+
+//==========================================================
+// Class representing a bounded heap keeping the best ScoredBooks offered to it
+// The worst kept book sits at the top of the heap, so a new book only has to beat that one to enter
+// Ties are broken by the order the books were offered in (the first one wins)
+class TopBooks 
+{
+	private:
+	    struct Entry 
+	    {
+	        Book* book;   // The book
+	        int score;    // Its match score
+	        int order;    // Position in which it was offered
+	    };
+	    MyVector<Entry> heap;   // Max-heap of the kept books, the worst one at position 0
+	    int capacity;           // Maximum number of books kept
+	    int offered;            // Number of books offered so far
+
+	    // Helper method to compare two entries, true if a ranks below b
+	    static bool worse(const Entry& a, const Entry& b);
+
+	    // Helper methods to restore the heap order after a change at the given position
+	    void siftUp(int pos);
+	    void siftDown(int pos);
+
+	public:
+	    // Constructor to initialize an empty heap keeping at most capacity books
+	    TopBooks(int capacity);
+
+	    // Method to get the score a book must beat to enter (INT_MAX while the heap is not full)
+	    int worstScore();
+
+	    // Method to offer a book, returns true if it is kept
+	    bool offer(Book* book, int score);
+
+	    // Method to move the kept books to results, best first (the heap is left empty)
+	    void drain(MyVector<ScoredBook>& results);
+};
+
 //==========================================================
 // Class representing a Tree structure
 class Tree 
 {
 	private:
 	    Node* root;  // Pointer to the root Node of the Tree
+	    unordered_multimap<string, BookRef> titleIndex; // Every book of the catalog indexed by its normalized title
+	    unordered_multimap<uint64_t, BookRef> isbnIndex; // Every book with an ISBN-10/13 indexed by its normalized ISBN
+	    BKTree titleTree;   // Metric index of the normalized titles, for fuzzy lookups
+	    BKTree authorTree;  // Metric index of the normalized authors, for fuzzy lookups
+	    TrigramIndex<Book*> bookGrams; // Trigram index of the normalized titles and authors, for substring search
+	    SuggestionDictionary* dictionary; // Deletion dictionary of the titles for "did you mean" (nullptr until built)
+	    bool lookupIndexesReady; // False while the title and ISBN indexes are deferred (built on the first lookup)
+	    bool searchIndexesReady; // False while the BK-trees and the trigram index are deferred (built on the first search)
+	    bool bulkLoading;   // True between beginBulkLoad and endBulkLoad, the book counts are not maintained
+	    unordered_map<Node*, unordered_set<string> > bulkKeys; // Duplicate keys (title, author, isbn) of the Nodes touched by a bulk load
+	    thread reaper;      // Background thread deleting the subtrees removed from the Tree (started on the first removal)
+	    mutex reaperLock;   // Guards reaperQueue, reaperIndexes and reaperStop
+	    condition_variable reaperWake; // Signals the reaper that a subtree was queued or that it must stop
+	    MyVector<Node*> reaperQueue;   // Detached subtrees waiting to be deleted
+	    MyVector<DroppedIndexes*> reaperIndexes; // Dropped indexes waiting to be deleted
+	    bool reaperStop;    // Set by the destructor, the reaper exits once its queue is empty
+	    MyVector<LayoutNode> layoutNodes; // Flattened layout: the Nodes in pre-order
+	    BookColumns layoutBooks;          // Flattened layout: the books, grouped by Node in the same order, and their categories
+	    uint64_t nextSequence; // Sequence number of the next book attached to the Tree
+	    bool nodeLayoutDirty; // True when a category was added or removed since layoutNodes was built
+	    bool layoutDirty;   // True when a book was added or removed since layoutBooks was built (it is rebuilt on the next traversal of a large subtree)
 
 	public:
 	    // Constructor to initialize the Tree with a root Node (Library)
@@ -50,6 +192,9 @@ class Tree
 	    // Method to get the root Node of the Tree
 	    Node* getRoot();
 
+	    // Method to get the number of categories in the Tree (the root is not counted)
+	    unsigned int getCategoryCount();
+
 	    // Method to print the entire Tree structure
 	    void print();
 
@@ -60,11 +205,63 @@ class Tree
 	    // Helper method to check if a Node is the last child of its parent
 	    bool isLastChild(Node* ptr);
 
+	    // Recursive helpers of findBook and removeBook, and the scan of find over the layout, they take an already normalized title/keyword
+	    Book* findBook_helper(Node* node, const string& titleKey);
+	    bool removeBook_helper(Node* node, const string& titleKey, Book*& removedBook, string& removedBookCategory);
+	    void find_scan(Node* node, const string& keywordKey, const unordered_set<Book*>* fuzzyHits, bool scanBooks, MyVector<Node*> &categoriesFound, MyVector<Book*> &booksFound);
+
+	    // Helper method to score a book against a normalized keyword, returns -1 if it does not match within maxScore
+	    int scoreBook(Book* book, const string& keywordKey, int maxScore);
+	    static int scoreKeys(const char* title, size_t titleLength, const char* author, size_t authorLength, const string& keywordKey, int maxScore);
+	    void findTop_scan(Node* node, const string& keywordKey, TopBooks& top);
+
+	    // Helper method to get the closest fuzzy match of a normalized title in the whole catalog
+	    Book* closestTitle(const string& titleKey);
+
+	    // Helper methods to order books in pre-order (by the layout position of their category, then in the order of the
+	    // category), valid once the Node layout is built, and to get the first book of a normalized title in that order
+	    static bool precedes(const Book* a, const Book* b);
+	    Book* firstWithTitle(const string& titleKey);
+
+	    // Helper methods to keep the catalog-wide indexes in sync with the books stored in the Tree
+	    void indexBook(Node* node, Book* book);
+	    void unindexBook(Book* book);
+	    unsigned int unindexSubtree(Node* node);
+	    void dropIndexes(bool lookupIndexes);
+	    void ensureLookupIndexes();
+	    void buildLookupIndexes_helper(Node* node);
+	    void ensureSearchIndexes();
+	    void collectBooks_helper(Node* node, MyVector<Book*>& books);
+
+	    // Helper methods of the bulk-load mode: duplicate keys of a Node, and post-order recount of the book counts
+	    // (countCategories counts the Nodes of a subtree, for the teardown summary)
+	    unordered_set<string>& bulkKeysOf(Node* node);
+	    unsigned int recountBooks(Node* node);
+	    unsigned int countCategories(Node* node);
+
+	    // Helper methods to rebuild the flattened layout if the Tree changed, and to get the first book of a layout position
+	    // (layoutBookStart(layoutNodes.size()) is the end of the book array)
+	    // ensureNodeLayout only rebuilds the Nodes, for the traversals that do not read any book (firstBook is not valid then)
+	    void ensureNodeLayout();
+	    void ensureLayout();
+	    void buildNodeLayout_helper(Node* node, uint32_t parent);
+	    uint32_t layoutBookStart(uint32_t position);
+
+	    // Helper method to get the books of a subtree in pre-order, from the layout or, while it is stale and the subtree
+	    // is small, by walking the Nodes (into scratch)
+	    void subtreeBooks(Node* node, MyVector<Book*>& scratch, Book* const*& first, Book* const*& last);
+
+	    // Helper methods to hand a detached subtree or dropped indexes to the reaper thread, and the loop of that thread
+	    void reap(Node* node);
+	    void reap(DroppedIndexes* indexes);
+	    void reaper_loop();
+
 	public:
-	    // Method to insert a new Node as a child of the given Node
-	    void insert(Node* node, string name);
+	    // Method to insert a new Node as a child of the given Node, it returns the new Node (nullptr if the name is taken)
+	    Node* insert(Node* node, string name);
 
 	    // Method to remove a child Node with the given name from the given node
+	    // The subtree is detached at once and freed by a background thread, a single summary line is printed
 	    void removeChild(Node* node, string child_name);
 
 	    // Method to check if a Node is the root of the Tree
@@ -79,9 +276,63 @@ class Tree
 	    // Method to get a child Node by its name
 	    Node* getChild(Node* ptr, string childname);
 
+	    // Method to rename a Node, returns false if a sibling already has the new name
+	    bool renameNode(Node* node, string newName);
+
 	    // A recursive method to update the book count in a Node(subcategory) and its parent Nodes by a given offset
 	    void updateBookCount(Node* ptr, int offset);
 
+	    // Method to add a book to a Node, it updates the book counts and the catalog-wide indexes
+	    void attachBook(Node* node, Book* book);
+
+	    // Methods to start and finish a bulk load (e.g. an import) of about expectedBooks books
+	    // In between, attachBook does not update the book counts (they are recomputed once by endBulkLoad)
+	    // and duplicate checks use a hash set instead of scanning the books of the category. A load at least as large
+	    // as the catalog also defers the search indexes, they are rebuilt on the first search
+	    void beginBulkLoad(unsigned int expectedBooks);
+	    void endBulkLoad();
+
+	    // Method to build the key used to detect duplicate books (same title, author and isbn)
+	    static string bookKey(const string& title, const string& author, const string& isbn);
+
+	    // Method to check if the catalog already holds a book: one with the same ISBN anywhere in the catalog if isbn is
+	    // an ISBN-10/13, otherwise one of the given Node with the same title, author and isbn
+	    bool containsBook(Node* node, const string& title, const string& author, const string& isbn);
+
+	    // Method to take the book at the given position out of a Node (the book is not deleted)
+	    void detachBook(Node* node, int index);
+
+	    // Method to find the Node (and the position in it) holding the given book, using the title index
+	    bool locateBook(Book* book, Node*& node, int& index);
+
+	    // Method to change the title of a book, it keeps the title index up to date
+	    void retitleBook(Book* book, string newTitle);
+
+	    // Method to change the author of a book, it keeps the author index up to date
+	    void reauthorBook(Book* book, string newAuthor);
+
+	    // Method to change the ISBN of a book, it keeps the ISBN index up to date
+	    void changeIsbn(Book* book, string newIsbn);
+
+	    // Method to change the publication year of a book, it keeps the flattened layout up to date
+	    void changeYear(Book* book, int newYear);
+
+	    // Method to find a book of the catalog by its normalized ISBN (see Book::normalizeIsbn), through the ISBN index
+	    // The returned BookRef holds nullptrs if no book has this ISBN
+	    BookRef findIsbn(uint64_t isbnKey);
+
+	    // Method to get the path of a Node relative to the root (e.g. "Physics/Cosmology")
+	    string categoryPath(Node* node);
+
+	    // Method to build the suggestion dictionary over the titles of the catalog
+	    void buildDictionary();
+
+	    // Method to get the suggestion dictionary (nullptr if it has not been built)
+	    const SuggestionDictionary* getDictionary();
+
+	    // Method to find up to maxCount books whose title is a fuzzy match of titleKey, closest first
+	    void suggestTitles(const string& titleKey, int maxCount, MyVector<BKMatch>& matches);
+
 	    // Method to find a book by its title in a Node
 	    Book* findBook(Node* node, string bookTitle);
 
@@ -89,20 +340,34 @@ class Tree
 	    // Method to remove a book by its title from a Node
 	    bool removeBook(Node* node, string bookTitle, Book*& removedBook, string& removedBookCategory);
 
-	    // A recursive method to print all books in a Node (category/subcategory) and its children
+	    // Method to remove a given book (e.g. one returned by findBook) from the catalog
+	    bool removeBook(Book* book, Book*& removedBook, string& removedBookCategory);
+
+	    // A method to print all books in a Node (category/subcategory) and its children, a scan over the flattened layout
 	    void printAll(Node* node);
 
 	    // A recursive method to find all books (containg the keyword in its title or author) and categories that containg the keyword in its name
 		void find(Node *node, string keyword, MyVector<Node*> &categoriesFound,MyVector<Book*> &booksFound);
 
-	    // A recursive method to export data from a Node (category/subcategory) and its children to a file
+	    // Method to find the count best matching books of the catalog for a keyword, best first
+	    void findTop(string keyword, int count, MyVector<ScoredBook> &results);
+
+	    // A method to export data from a Node (category/subcategory) and its children to a file
 	    int exportData(Node* node, ofstream& file);
 
+	    // Method to save the catalog to a binary snapshot, it returns the number of books saved (-1 and the reason in error on failure)
+	    int saveSnapshot(const string& path, string& error);
+
+	    // Method to load a binary snapshot into an empty catalog, it returns the number of books loaded (-1 and the reason in error on failure)
+	    int loadSnapshot(const string& path, string& error);
+
+	private:
+	    // Recursive part of saveSnapshot, it appends a Node and its books (pre-order) and returns the index of the Node
+	    uint32_t saveSnapshot_helper(Node* node, uint32_t parent, string& nodes, string& books, string& strings, unordered_map<string, uint32_t>& offsets);
+
+	public:
 	    // Method to check if the Tree is empty
 	    bool isEmpty();
 };
 
-// Function to compute the Levenshtein distance between two strings
-int levenshtein_distance(const std::string &s1, const std::string &s2);
-
 #endif
\ No newline at end of file
@@ -0,0 +1,269 @@
+#ifndef TRIGRAM_H
+#define TRIGRAM_H
+
+//============================================================================
+// Name         : trigram.h
+// Author       : Bertin Iradukunda
+// Version      : 1.0
+// Date Created : October 16, 2026
+// Date Modified: October 16, 2026
+// Description  : Trigram inverted index used to find substring matches without scanning the catalog
+//============================================================================
+
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <cstdint>
+#include <utility>
+#include "myvector.h"
+
+using namespace std;
+
+// Template class for a trigram (3-gram) inverted index
+// Every item gets an id when it is added, and the posting list of a trigram holds, in increasing order,
+// the ids of the items whose text contains it. A string of 3 or more characters can only be a substring
+// of a text containing all its trigrams, so intersecting their posting lists gives a (small) set of
+// candidates that only have to be verified with a real substring test
+// Removing an item only leaves a hole: its id stays in the posting lists (and is skipped by candidates)
+// until more than half of the ids are dead, then the live items are renumbered and all the lists compacted in one pass
+template <typename T>
+class TrigramIndex
+{
+	private:
+	    MyVector<T> items;                                 // Indexed items, by id (removed items leave a T() hole)
+	    unordered_map<T, int> ids;                         // Id of each indexed item
+	    unordered_map<uint32_t, MyVector<int> > postings;  // Trigram -> sorted ids of the items containing it
+	    int itemCount;                                     // Number of indexed items
+	    int deadIds;                                       // Ids of removed items still present in the posting lists
+
+	    // Helper method to collect the distinct trigrams of a string
+	    static void trigrams(const string& text, unordered_set<uint32_t>& grams);
+
+	    // Helper method to find the position of the first id >= id in a sorted posting list
+	    static int lowerBound(MyVector<int>& list, int id);
+
+	    // Helper method to renumber the live items and drop the ids of the removed items from every posting list
+	    void compact();
+
+	public:
+	    // Constructor to initialize an empty index
+	    TrigramIndex() : itemCount(0), deadIds(0) {}
+
+	    // Method to index an item under one or two texts (e.g. title and author)
+	    void add(T item, const string& text, const string& text2 = "");
+
+	    // Method to remove an item (O(1), its id stays in the posting lists until they are compacted)
+	    void remove(T item);
+
+	    // Method to remove every item
+	    void clear();
+
+	    // Method to exchange the contents of two indexes (O(1), e.g. to free a whole index on another thread)
+	    void swap(TrigramIndex& other);
+
+	    // Method to get the candidates for a substring query, in the order they were added
+	    // It returns false (and no candidate) if the query is too short to be looked up
+	    bool candidates(const string& query, MyVector<T>& found);
+
+	    // Method to get the number of indexed items
+	    int size() const { return itemCount; }
+};
+
+// This method collects the distinct trigrams of a string, packed in 24 bits
+template <typename T>
+void TrigramIndex<T>::trigrams(const string& text, unordered_set<uint32_t>& grams)
+{
+	for (size_t i = 0; i + 2 < text.length(); i++)
+	{
+		uint32_t gram = ((uint32_t)(unsigned char)text[i] << 16) |
+		                ((uint32_t)(unsigned char)text[i + 1] << 8) |
+		                (uint32_t)(unsigned char)text[i + 2];
+		grams.insert(gram);
+	}
+}
+
+// This method returns the position of the first id >= id in a sorted posting list (binary search)
+template <typename T>
+int TrigramIndex<T>::lowerBound(MyVector<int>& list, int id)
+{
+	int lo = 0, hi = list.size();
+	while (lo < hi)
+	{
+		int mid = (lo + hi) / 2;
+		if (list[mid] < id) lo = mid + 1;
+		else hi = mid;
+	}
+	return lo;
+}
+
+// This method indexes an item under the trigrams of one or two texts
+// Ids are handed out in increasing order, so appending keeps every posting list sorted
+template <typename T>
+void TrigramIndex<T>::add(T item, const string& text, const string& text2)
+{
+	if (ids.count(item) > 0)
+	{
+		return; // Already indexed
+	}
+	int id = items.size();
+	items.push_back(item);
+	ids[item] = id;
+	itemCount++;
+
+	unordered_set<uint32_t> grams;
+	trigrams(text, grams);
+	trigrams(text2, grams);
+	for (uint32_t gram : grams)
+	{
+		postings[gram].push_back(id);
+	}
+}
+
+// This method removes an item by leaving a hole at its id
+// Erasing the id from the posting lists would shift the long lists (e.g. of a common trigram) once per removed item,
+// so they are only compacted when the dead ids outnumber the live ones
+template <typename T>
+void TrigramIndex<T>::remove(T item)
+{
+	typename unordered_map<T, int>::iterator it = ids.find(item);
+	if (it == ids.end())
+	{
+		return; // Not indexed
+	}
+	int id = it->second;
+	ids.erase(it);
+	items[id] = T();
+	itemCount--;
+	deadIds++;
+
+	if (deadIds > itemCount)
+	{
+		compact();
+	}
+}
+
+// This method gives the live items the ids 0 .. itemCount - 1, in the order they were added, and rewrites the posting lists
+// with the new ids (the renumbering keeps the order of the ids, so the lists stay sorted). Without it the ids, and the
+// items array, would keep growing with every book that is removed and added again (e.g. by an edit)
+template <typename T>
+void TrigramIndex<T>::compact()
+{
+	MyVector<int> renumbered(items.size()); // New id of each old id, -1 for a removed item
+	MyVector<T> live(itemCount);
+	for (int id = 0; id < items.size(); id++)
+	{
+		if (items[id] != T())
+		{
+			renumbered.push_back(live.size());
+			ids[items[id]] = live.size();
+			live.push_back(items[id]);
+		}
+		else
+		{
+			renumbered.push_back(-1);
+		}
+	}
+	std::swap(items, live);
+
+	typename unordered_map<uint32_t, MyVector<int> >::iterator posting = postings.begin();
+	while (posting != postings.end())
+	{
+		MyVector<int>& list = posting->second;
+		int kept = 0;
+		for (int i = 0; i < list.size(); i++)
+		{
+			if (renumbered[list[i]] >= 0)
+			{
+				list[kept++] = renumbered[list[i]];
+			}
+		}
+		while (list.size() > kept)
+		{
+			list.erase(list.size() - 1);
+		}
+		if (list.empty())
+		{
+			posting = postings.erase(posting);
+		}
+		else
+		{
+			++posting;
+		}
+	}
+	deadIds = 0;
+}
+
+// This method removes every item and every posting list
+template <typename T>
+void TrigramIndex<T>::clear()
+{
+	items.clear();
+	ids.clear();
+	postings.clear();
+	itemCount = 0;
+	deadIds = 0;
+}
+
+// This method exchanges the items, the posting lists and the counters of two indexes
+template <typename T>
+void TrigramIndex<T>::swap(TrigramIndex& other)
+{
+	std::swap(items, other.items);
+	ids.swap(other.ids);
+	postings.swap(other.postings);
+	std::swap(itemCount, other.itemCount);
+	std::swap(deadIds, other.deadIds);
+}
+
+// This method finds the candidates for a substring query by intersecting the posting lists of its trigrams
+// The intersection starts from the shortest list, and each of its ids is looked up (binary search) in the
+// other lists, so the cost depends on the rarest trigram rather than on the size of the catalog
+template <typename T>
+bool TrigramIndex<T>::candidates(const string& query, MyVector<T>& found)
+{
+	if (query.length() < 3)
+	{
+		return false; // No trigram to look up
+	}
+	unordered_set<uint32_t> grams;
+	trigrams(query, grams);
+
+	// Gather the posting lists, shortest first
+	MyVector<MyVector<int>*> lists;
+	for (uint32_t gram : grams)
+	{
+		typename unordered_map<uint32_t, MyVector<int> >::iterator posting = postings.find(gram);
+		if (posting == postings.end())
+		{
+			return true; // A trigram that no item contains: no candidate
+		}
+		MyVector<int>* list = &posting->second;
+		int pos = lists.size();
+		lists.push_back(list);
+		while (pos > 0 && lists[pos - 1]->size() > list->size())
+		{
+			lists[pos] = lists[pos - 1];
+			pos--;
+		}
+		lists[pos] = list;
+	}
+
+	MyVector<int>& shortest = *lists[0];
+	for (int i = 0; i < shortest.size(); i++)
+	{
+		int id = shortest[i];
+		bool inAll = true;
+		for (int l = 1; l < lists.size() && inAll; l++)
+		{
+			int pos = lowerBound(*lists[l], id);
+			inAll = pos < lists[l]->size() && (*lists[l])[pos] == id;
+		}
+		if (inAll && items[id] != T())
+		{
+			found.push_back(items[id]);
+		}
+	}
+	return true;
+}
+
+#endif